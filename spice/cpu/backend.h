@@ -2,17 +2,38 @@
 
 #include <spice/util/random.h>
 
+#include <atomic>
+#include <type_traits>
+
 
 namespace spice
 {
 struct backend
 {
+	// Independent random streams, see seek()
+	enum stream : uint_
+	{
+		neuron_init,
+		neuron_update,
+		synapse_init,
+		synapse_update,
+		neuron_receive
+	};
+
 	explicit backend( ulong_ seed )
 	    : rng( seed )
+	    , _seed( seed )
 	{
 		spice_assert( seed > 0 );
 	}
 
+	ulong_ seed() const { return _seed; }
+
+	// Subsequent calls to rand() draw from the stream identified by (s, id, step). Backends
+	// constructed with the same seed thus produce the same no.s for the same neuron/synapse,
+	// regardless of which thread processes it or in which order.
+	void seek( stream s, uint_ id, int_ step = 0 ) { rng.seek( s, id, (uint_)step ); }
+
 	template <typename T>
 	static void atomic_add( T & var, T val )
 	{
@@ -47,6 +68,60 @@ struct backend
 	}
 
 private:
-	util::xoroshiro128p rng;
+	util::philox4x32_10 rng;
+	ulong_ _seed;
+};
+
+// Variant of backend whose atomic_add() is thread-safe, for delivering spikes from several
+// threads concurrently
+struct atomic_backend : backend
+{
+	explicit atomic_backend( backend const & bak )
+	    : backend( bak )
+	{
+	}
+
+	template <typename T>
+	static void atomic_add( T & var, T val )
+	{
+#ifdef __cpp_lib_atomic_ref
+		std::atomic_ref<T>( var ).fetch_add( val, std::memory_order_relaxed );
+#elif defined( __GNUC__ )
+		if constexpr( std::is_integral_v<T> )
+			__atomic_fetch_add( &var, val, __ATOMIC_RELAXED );
+		else
+		{
+			T old;
+			__atomic_load( &var, &old, __ATOMIC_RELAXED );
+			T desired = old + val;
+			while( !__atomic_compare_exchange(
+			    &var, &old, &desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) )
+				desired = old + val;
+		}
+#else
+		auto & a = reinterpret_cast<std::atomic<T> &>( var );
+		static_assert( sizeof( a ) == sizeof( T ) );
+
+		T old = a.load( std::memory_order_relaxed );
+		while( !a.compare_exchange_weak( old, old + val, std::memory_order_relaxed ) )
+			;
+#endif
+	}
+};
+
+// Variant of backend without rand(), passed to update() of neurons that declare
+// !stochastic_update. Models which draw random no.s anyway fail to compile.
+struct deterministic_backend : private backend
+{
+	explicit deterministic_backend( backend const & bak )
+	    : backend( bak )
+	{
+	}
+
+	using backend::atomic_add;
+	using backend::clamp;
+	using backend::exp;
+	using backend::max;
+	using backend::min;
 };
 } // namespace spice
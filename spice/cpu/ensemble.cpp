@@ -0,0 +1,344 @@
+#include <spice/cpu/ensemble.h>
+
+#include <spice/cpu/util/ell.h>
+#include <spice/models/brunel.h>
+#include <spice/models/synth.h>
+#include <spice/models/vogels_abbott.h>
+#include <spice/util/assert.h>
+#include <spice/util/circular_buffer.h>
+#include <spice/util/type_traits.h>
+
+#include <algorithm>
+
+
+using namespace spice::util;
+
+
+namespace
+{
+// Accesses the attributes of instance k of the i-th neuron, stored instance-major
+template <typename PTuple>
+class instance_iter
+{
+public:
+	instance_iter( PTuple const & data, size_ i, size_ k, size_ size )
+	    : _data( &data )
+	    , _i( i )
+	    , _offset( i * size + k )
+	{
+	}
+
+	size_ id() const { return _i; }
+
+	template <int_ I>
+	auto & get()
+	{
+		return std::get<I>( *_data )[_offset];
+	}
+
+private:
+	PTuple const * _data = nullptr;
+	size_ _i = 0;
+	size_ _offset = 0;
+};
+
+// Accesses a local copy of the i-th neuron's attributes (one instance's)
+template <typename Tuple>
+class local_iter
+{
+public:
+	local_iter( Tuple & attrs, size_ i )
+	    : _attrs( &attrs )
+	    , _i( i )
+	{
+	}
+
+	size_ id() const { return _i; }
+
+	template <int_ I>
+	auto & get()
+	{
+		return std::get<I>( *_attrs );
+	}
+
+private:
+	Tuple * _attrs = nullptr;
+	size_ _i = 0;
+};
+
+// Copies the attributes stored at 'offset' into 'attrs' (load) or back (store)
+template <typename Tuple, typename PTuple, size_... I>
+void load( Tuple & attrs, PTuple const & data, size_ offset, std::index_sequence<I...> )
+{
+	( ( std::get<I>( attrs ) = std::get<I>( data )[offset] ), ... );
+}
+template <typename Tuple, typename PTuple, size_... I>
+void store( Tuple const & attrs, PTuple const & data, size_ offset, std::index_sequence<I...> )
+{
+	( ( std::get<I>( data )[offset] = std::get<I>( attrs ) ), ... );
+}
+
+// Stand-in for the (stateless) synapses passed to receive()
+struct no_synapse
+{
+	size_ id() const { return 0; }
+};
+} // namespace
+
+
+namespace spice::cpu
+{
+template <typename Model>
+size_ ensemble<Model>::MASK_WORDS() const
+{
+	return ( size() + 63 ) / 64;
+}
+
+template <typename Model>
+ensemble<Model>::ensemble(
+    layout const & desc,
+    float const dt,
+    int_ const delay,
+    std::vector<ulong_> const & seeds,
+    int_ const num_threads /* = 1 */ )
+    : _dt( dt )
+    , _delay( delay )
+    , _size( seeds.size() )
+    , _pool( num_threads )
+{
+	spice_assert( dt > 0.0f );
+	spice_assert( delay >= 1 );
+	spice_assert(
+	    desc.min_delay( delay ) == delay && desc.max_delay( delay ) == delay,
+	    "per-connection delays are not supported by this backend" );
+	spice_assert( !seeds.empty(), "ensemble requires at least 1 instance" );
+
+	for( int_ i = 0; i < num_threads; i++ )
+		for( ulong_ seed : seeds ) _backends.emplace_back( seed );
+
+	_spikes.ids.resize( delay );
+	_spikes.masks.resize( delay );
+	_spikes.local_ids.resize( num_threads );
+	_spikes.local_masks.resize( num_threads );
+
+	adj_list::generate( desc, _graph.edges, _graph.offsets, seeds.front(), num_threads );
+	_graph.adj = { desc.size(), _graph.offsets.data(), _graph.edges.data() };
+	_info = make_info<Model>( info() );
+	_propagator = { Model::neuron::dynamics( _info ), dt };
+
+	if constexpr( Model::neuron::size > 0 )
+	{
+		auto const & info = _info;
+
+		_neurons.resize( num_neurons() * size() );
+		auto const neurons = _neurons.data();
+		_pool.parallel_for( num_neurons(), [&]( size_ first, size_ last, int_ ithread ) {
+			for( size_ i = first; i < last; i++ )
+				for( size_ k = 0; k < size(); k++ )
+				{
+					auto & bak = _backends[ithread * size() + k];
+					bak.seek( backend::neuron_init, narrow<uint_>( i ) );
+					Model::neuron::template init(
+					    instance_iter( neurons, i, k, size() ), info, bak );
+				}
+		} );
+	}
+}
+
+template <typename Model>
+void ensemble<Model>::step( std::vector<std::vector<int>> * out_spikes /* = nullptr */ )
+{
+	spice_assert( _i < std::numeric_limits<decltype( _i )>::max() );
+
+	int_ const istep = _i++;
+	float const dt = update_dt<typename Model::neuron>( _simtime.add( this->dt() ), this->dt() );
+
+	auto const & info = _info;
+	auto const neurons = _neurons.data();
+	size_ const K = size();
+	size_ const W = MASK_WORDS();
+
+	auto & ids = _spikes.ids[circidx( istep, delay() )];
+	auto & masks = _spikes.masks[circidx( istep, delay() )];
+
+	// Every thread owns a contiguous range of neurons and both receives into and updates them,
+	// see cpu::snn.
+	_pool.run( [&]( int_ const ithread ) {
+		auto const [first, last] =
+		    util::thread_pool::chunk( num_neurons(), _pool.size(), ithread, 64 );
+		backend * const baks = &_backends[ithread * K];
+
+		// Receive spikes: visit every spiking neuron's edges into [first, last) once and deliver
+		// them to all instances in which it spiked. Spikes are visited in ascending order, so
+		// every instance accumulates its inputs in the same order as cpu::snn.
+		if( istep >= delay() && first < last )
+		{
+			for( size_ s = 0; s < ids.size(); s++ )
+			{
+				int_ const src = ids[s];
+				ulong_ const * const mask = &masks[s * W];
+
+				auto const row = _graph.adj.neighbors( src );
+				auto const a = std::lower_bound( row.begin(), row.end(), narrow<int>( first ) );
+				auto const b = std::lower_bound( a, row.end(), narrow<int>( last ) );
+
+				with_population<typename Model::neuron>( src, info, [&]( auto const P ) {
+					for( auto it = a; it != b; ++it )
+					{
+						uint_ const syn =
+						    narrow<uint_>( _graph.adj.edge_index( src, it - row.begin() ) );
+
+						for( size_ k = 0; k < K; k++ )
+							if( mask[k / 64] >> ( k % 64 ) & 1u )
+							{
+								baks[k].seek( backend::neuron_receive, syn, istep );
+								receive_spike<typename Model::neuron, decltype( P )::value>(
+								    src,
+								    instance_iter( neurons, *it, k, K ),
+								    no_synapse(),
+								    info,
+								    baks[k] );
+							}
+					}
+				} );
+			}
+		}
+
+		// Update neurons
+		auto & local_ids = _spikes.local_ids[ithread];
+		auto & local_masks = _spikes.local_masks[ithread];
+		local_ids.clear();
+		local_masks.clear();
+
+		// All K copies of neuron i are adjacent. update() operates on a local copy of each, which
+		// is written back unconditionally, so that the compiler can if-convert it. For models
+		// without stochastic_update (which need no per-instance random stream) the loop over the
+		// copies then vectorizes, others seek every instance's own stream first.
+		auto const propagator = _propagator;
+		deterministic_backend lanes_bak( baks[0] );
+		std::vector<int_> spiked( K );
+		std::vector<ulong_> mask( W );
+		for_each_population<typename Model::neuron>(
+		    narrow<int>( first ),
+		    narrow<int>( last ),
+		    info,
+		    [&]( auto const P, int_ const a, int_ const b ) {
+			    constexpr int_ p = decltype( P )::value;
+
+			    for( size_ i = a; i < narrow<size_>( b ); i++ )
+			    {
+				    // Instances are independent
+#pragma GCC ivdep
+				    for( size_ k = 0; k < K; k++ )
+				    {
+					    constexpr auto attrs = std::make_index_sequence<Model::neuron::size>();
+					    typename Model::neuron::tuple_t x;
+					    load( x, neurons, i * K + k, attrs );
+
+					    local_iter const n( x, i );
+					    if constexpr( Model::neuron::stochastic_update )
+					    {
+						    baks[k].seek( backend::neuron_update, narrow<uint_>( i ), istep );
+						    spiked[k] =
+						        update_neuron<typename Model::neuron, p>( n, dt, info, baks[k] );
+					    }
+					    else
+						    spiked[k] =
+						        update_neuron<typename Model::neuron, p>( n, dt, info, lanes_bak );
+					    propagator.apply( n );
+
+					    store( x, neurons, i * K + k, attrs );
+				    }
+
+				    std::fill( mask.begin(), mask.end(), 0 );
+				    bool any = false;
+				    for( size_ k = 0; k < K; k++ )
+				    {
+					    mask[k / 64] |= ulong_( spiked[k] ) << ( k % 64 );
+					    any |= spiked[k];
+				    }
+
+				    if( any )
+				    {
+					    local_ids.push_back( narrow<int>( i ) );
+					    local_masks.insert( local_masks.end(), mask.begin(), mask.end() );
+				    }
+			    }
+		    } );
+	} );
+
+	// Overwrites the spikes we just received (delay steps ago)
+	ids.clear();
+	masks.clear();
+	for( int_ i = 0; i < _pool.size(); i++ )
+	{
+		ids.insert( ids.end(), _spikes.local_ids[i].begin(), _spikes.local_ids[i].end() );
+		masks.insert( masks.end(), _spikes.local_masks[i].begin(), _spikes.local_masks[i].end() );
+	}
+
+	if( out_spikes )
+	{
+		out_spikes->resize( K );
+		for( auto & spikes : *out_spikes ) spikes.clear();
+
+		for( size_ s = 0; s < ids.size(); s++ )
+			for( size_ k = 0; k < K; k++ )
+				if( masks[s * W + k / 64] >> ( k % 64 ) & 1u )
+					( *out_spikes )[k].push_back( ids[s] );
+	}
+}
+
+
+template <typename Model>
+size_ ensemble<Model>::size() const
+{
+	return _size;
+}
+template <typename Model>
+size_ ensemble<Model>::num_neurons() const
+{
+	return _graph.adj.num_nodes();
+}
+template <typename Model>
+size_ ensemble<Model>::num_synapses() const
+{
+	return _graph.adj.num_edges();
+}
+template <typename Model>
+float ensemble<Model>::dt() const
+{
+	return _dt;
+}
+template <typename Model>
+int_ ensemble<Model>::delay() const
+{
+	return _delay;
+}
+template <typename Model>
+snn_info ensemble<Model>::info() const
+{
+	return make_snn_info<typename Model::neuron>( num_neurons(), num_synapses(), delay(), dt() );
+}
+
+template <typename Model>
+std::pair<std::vector<int>, size_> ensemble<Model>::adj() const
+{
+	return util::to_ell( _graph.adj );
+}
+template <typename Model>
+std::vector<typename Model::neuron::tuple_t>
+ensemble<Model>::neurons( size_ const instance ) const
+{
+	spice_assert( instance < size() );
+
+	auto const all = _neurons.to_aos();
+
+	std::vector<typename Model::neuron::tuple_t> result;
+	for( size_ i = instance; i < all.size(); i += size() ) result.push_back( all[i] );
+	return result;
+}
+
+template class ensemble<vogels_abbott>;
+template class ensemble<brunel>;
+template class ensemble<synth>;
+} // namespace spice::cpu
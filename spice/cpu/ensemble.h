@@ -0,0 +1,103 @@
+#pragma once
+
+#include <spice/cpu/backend.h>
+#include <spice/cpu/util/hbuffer.h>
+#include <spice/cpu/util/thread_pool.h>
+#include <spice/models/model.h>
+#include <spice/snn_info.h>
+#include <spice/util/adj_list.h>
+#include <spice/util/layout.h>
+#include <spice/util/meta.h>
+#include <spice/util/numeric.h>
+#include <spice/util/propagator.h>
+
+#include <vector>
+
+
+namespace spice
+{
+namespace cpu
+{
+// Seed ensemble: simulates seeds.size() instances of the same network side by side, which differ
+// only in their seeds. All instances share one graph (generated from seeds.front()) and the
+// model's constants (parameter sweeps are not supported) but draw their initial states and
+// random no.s from their own seed, so instance k behaves exactly like
+// cpu::snn( desc, dt, delay, *, seeds[k] ) would if it were given the same graph. In particular,
+// instances whose seed equals seeds.front() are identical to cpu::snn( ..., seeds.front() ).
+//
+// Neuron state is instance-major (attribute[i * size() + k]), so all copies of a neuron are
+// updated by one contiguous loop over the instances, and every edge is read once per step for
+// all instances. That loop vectorizes for neurons without stochastic_update; others have to
+// seek every instance's own random stream first. Only models without synapse state are
+// supported: plastic synapses would diverge between instances.
+template <typename Model>
+class ensemble
+{
+public:
+	static_assert( Model::synapse::size == 0, "ensembles do not support synapse state" );
+	static_assert( Model::neuron::input::size == 0, "ensembles do not support neuron inputs" );
+
+	ensemble(
+	    spice::util::layout const & desc,
+	    float dt,
+	    int_ delay,
+	    std::vector<ulong_> const & seeds,
+	    int_ num_threads = 1 );
+
+	// (opt.) writes the spikes of instance k to (*out_spikes)[k]
+	void step( std::vector<std::vector<int>> * out_spikes = nullptr );
+
+	// no. of instances
+	size_ size() const;
+	size_ num_neurons() const;
+	size_ num_synapses() const;
+	float dt() const;
+	int_ delay() const;
+	snn_info info() const;
+
+	// (edges, width), see cpu::snn
+	std::pair<std::vector<int>, size_> adj() const;
+	std::vector<typename Model::neuron::tuple_t> neurons( size_ instance ) const;
+
+private:
+	float const _dt;
+	int_ const _delay;
+	size_ const _size;
+	int_ _i = 0;
+	spice::util::kahan_sum<float> _simtime;
+
+	// num_neurons x size(), instance-major
+	spice::util::soa_t<util::hbuffer, typename Model::neuron> _neurons;
+	// see spice::neuron::dynamics()
+	spice::util::propagator_t<typename Model::neuron> _propagator;
+	// info() along with the model's constants
+	spice::info_t<Model> _info;
+	struct
+	{
+		// CSR
+		std::vector<int> edges;
+		std::vector<size_> offsets;
+		spice::util::adj_list adj;
+	} _graph;
+
+	struct
+	{
+		// delay rows, row i holds the neurons that spiked (in any instance) during step i (mod
+		// delay), ascending, ...
+		std::vector<std::vector<int>> ids;
+		// ... along with MASK_WORDS() words per neuron, bit k indicating whether instance k spiked
+		std::vector<std::vector<ulong_>> masks;
+
+		// per-thread spikes, concatenated into ids/masks after each update
+		std::vector<std::vector<int>> local_ids;
+		std::vector<std::vector<ulong_>> local_masks;
+	} _spikes;
+
+	util::thread_pool _pool;
+	// size() per worker thread, [ithread * size() + k] is thread ithread's backend for instance k
+	std::vector<backend> _backends;
+
+	size_ MASK_WORDS() const;
+};
+} // namespace cpu
+} // namespace spice
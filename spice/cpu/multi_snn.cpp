@@ -0,0 +1,221 @@
+#include <spice/cpu/multi_snn.h>
+
+#include <spice/cpu/util/ell.h>
+#include <spice/cpu/util/numa.h>
+#include <spice/models/brunel.h>
+#include <spice/models/brunel_with_inputs.h>
+#include <spice/models/brunel_with_plasticity.h>
+#include <spice/models/synth.h>
+#include <spice/models/vogels_abbott.h>
+#include <spice/util/assert.h>
+#include <spice/util/type_traits.h>
+
+#include <algorithm>
+
+
+using namespace spice::util;
+
+
+static ulong_ _seed = 1337;
+
+
+// Concatenates row i of all partitions' (ELL) adjacency lists (and synapses, if any), for every
+// i. Partitions own ascending ranges of neurons, so the merged rows are sorted again.
+template <typename Syn>
+static std::pair<std::vector<int>, size_> merge(
+    std::vector<std::pair<std::vector<int>, size_>> const & parts,
+    std::vector<std::vector<Syn>> const & syns,
+    size_ const N,
+    std::vector<Syn> & out_syns )
+{
+	std::vector<adj_list> adj;
+	for( auto const & p : parts ) adj.push_back( { N, p.second, p.first.data() } );
+
+	size_ deg = 0;
+	for( size_ i = 0; i < N; i++ )
+	{
+		size_ sum = 0;
+		for( auto const & a : adj ) sum += a.neighbors( i ).size();
+		deg = std::max( deg, sum );
+	}
+	deg = spice::cpu::util::ell_width( deg );
+
+	std::vector<int> result( deg * N, -1 );
+	if( !syns.empty() ) out_syns.resize( result.size() );
+
+	for( size_ i = 0; i < N; i++ )
+	{
+		size_ offset = i * deg;
+		for( size_ p = 0; p < adj.size(); p++ )
+		{
+			auto const row = adj[p].neighbors( i );
+			for( size_ j = 0; j < row.size(); j++, offset++ )
+			{
+				result[offset] = row[j];
+				if( !syns.empty() ) out_syns[offset] = syns[p][adj[p].edge_index( i, j )];
+			}
+		}
+	}
+
+	return { result, deg };
+}
+
+
+namespace spice::cpu
+{
+template <typename Model>
+multi_snn<Model>::multi_snn(
+    spice::util::layout const & desc,
+    float const dt,
+    int_ const delay /* = 1 */,
+    int_ const num_partitions /* = 1 */,
+    int_ const threads_per_partition /* = 1 */,
+    ulong_ seed /* = 0 */,
+    bool const numa /* = false */ )
+    : ::spice::snn<Model>( dt, desc.min_delay( delay ) )
+    , _pool( num_partitions + numa )
+    , _nets( num_partitions )
+    , _spikes( num_partitions, std::vector<std::vector<int>>( desc.min_delay( delay ) ) )
+{
+	spice_assert( num_partitions >= 1 );
+
+	// All partitions must agree on the seed
+	if( !seed ) seed = hash( _seed++ );
+
+	auto const nodes = numa ? util::numa_nodes() : std::vector<int>();
+
+	// Partitions are constructed by the threads that later simulate them
+	_run( [&]( int_ const ipart ) {
+		// Threads spawned by the partition (its workers) inherit the affinity
+		if( numa )
+			util::set_thread_affinity(
+			    util::numa_cpus( nodes[ipart * nodes.size() / num_partitions] ) );
+
+		// Round to multiples of 64 (see cpu::snn)
+		auto const round = [&]( size_ const x ) {
+			return std::min( desc.size(), ( x + 32 ) / 64 * 64 );
+		};
+
+		auto const [first, last] = desc.static_load_balance( num_partitions, ipart );
+
+		_nets[ipart] = std::make_unique<cpu::snn<Model>>(
+		    desc,
+		    dt,
+		    delay,
+		    std::make_pair(
+		        round( first ), ipart + 1 == num_partitions ? desc.size() : round( last ) ),
+		    threads_per_partition,
+		    seed );
+	} );
+}
+
+template <typename Model>
+void multi_snn<Model>::step( std::vector<int> * out_spikes /* = nullptr */ )
+{
+	_advance();
+
+	if( out_spikes ) out_spikes->clear();
+
+	for( int_ i = 0; i < this->delay(); i++ )
+		this->_step( [&]( int_ const istep, float ) {
+			auto const spikes = _exchange( istep, i );
+			if( out_spikes ) out_spikes->insert( out_spikes->end(), spikes.begin(), spikes.end() );
+		} );
+}
+
+template <typename Model>
+void multi_snn<Model>::_advance()
+{
+	_run( [&]( int_ const ipart ) {
+		int_ i = 0;
+		_nets[ipart]->run( this->delay(), [&]( int_, nonstd::span<int const> spikes ) {
+			_spikes[ipart][i++].assign( spikes.begin(), spikes.end() );
+		} );
+	} );
+}
+
+template <typename Model>
+nonstd::span<int const> multi_snn<Model>::_exchange( int_ const istep, int_ const i )
+{
+	_merged.clear();
+	for( auto const & spikes : _spikes )
+		_merged.insert( _merged.end(), spikes[i].begin(), spikes[i].end() );
+
+	if( _nets.size() > 1 )
+		_run( [&]( int_ const ipart ) { _nets[ipart]->set_spikes( istep, _merged ); } );
+
+	return _merged;
+}
+
+template <typename Model>
+template <typename F>
+void multi_snn<Model>::_run( F && f )
+{
+	// With numa, thread 0 (the caller) sits idle so it doesn't have to be pinned
+	int_ const offset = _pool.size() - narrow<int_>( _nets.size() );
+	_pool.run( [&]( int_ const ithread ) {
+		if( ithread >= offset ) f( ithread - offset );
+	} );
+}
+
+template <typename Model>
+size_ multi_snn<Model>::num_neurons() const
+{
+	return _nets.front()->num_neurons();
+}
+template <typename Model>
+size_ multi_snn<Model>::num_synapses() const
+{
+	// Partitions hold disjoint subsets of the edges
+	size_ result = 0;
+	for( auto const & net : _nets ) result += net->num_synapses();
+	return result;
+}
+
+template <typename Model>
+std::pair<std::vector<int>, size_> multi_snn<Model>::adj() const
+{
+	std::vector<std::pair<std::vector<int>, size_>> parts;
+	for( auto const & net : _nets ) parts.push_back( net->adj() );
+
+	std::vector<int> dummy;
+	return merge<int>( parts, {}, num_neurons(), dummy );
+}
+template <typename Model>
+std::vector<typename Model::neuron::tuple_t> multi_snn<Model>::neurons() const
+{
+	std::vector<typename Model::neuron::tuple_t> result;
+	for( auto const & net : _nets )
+	{
+		auto const tmp = net->neurons();
+		result.insert( result.end(), tmp.begin(), tmp.end() );
+	}
+	return result;
+}
+template <typename Model>
+std::vector<typename Model::synapse::tuple_t> multi_snn<Model>::synapses() const
+{
+	if constexpr( Model::synapse::size > 0 )
+	{
+		std::vector<std::pair<std::vector<int>, size_>> parts;
+		std::vector<std::vector<typename Model::synapse::tuple_t>> syns;
+		for( auto const & net : _nets )
+		{
+			parts.push_back( net->adj() );
+			syns.push_back( net->synapses() );
+		}
+
+		std::vector<typename Model::synapse::tuple_t> result;
+		merge( parts, syns, num_neurons(), result );
+		return result;
+	}
+	else
+		return {};
+}
+
+template class multi_snn<vogels_abbott>;
+template class multi_snn<brunel>;
+template class multi_snn<brunel_with_inputs>;
+template class multi_snn<brunel_with_plasticity>;
+template class multi_snn<synth>;
+} // namespace spice::cpu
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <spice/cpu/snn.h>
+#include <spice/cpu/util/thread_pool.h>
+#include <spice/snn.h>
+
+#include <memory>
+#include <vector>
+
+
+namespace spice::cpu
+{
+// Splits a network into partitions (via layout::static_load_balance) which are simulated
+// concurrently, each by its own worker thread(s). Since spikes take at least delay() steps to
+// arrive (the smallest delay of any connection, see cpu::snn), partitions only exchange spikes
+// every delay() steps.
+// 'numa' maps partitions to NUMA nodes (in blocks, see util::numa_nodes()) and pins their threads
+// to them. Each partition is constructed by its own thread(s), so its neurons, synapses and edges
+// are first-touched on its node. Only the spike exchange crosses nodes. The calling thread only
+// coordinates and remains unpinned. (util::numa_alloc_stats gives a rough, system-wide idea of
+// page placement.)
+template <typename Model>
+class multi_snn : public ::spice::snn<Model>
+{
+public:
+	multi_snn(
+	    spice::util::layout const & desc,
+	    float dt,
+	    int_ delay = 1,
+	    int_ num_partitions = 1,
+	    int_ threads_per_partition = 1,
+	    ulong_ seed = 0,
+	    bool numa = false );
+
+	// Simulates delay() steps, writes the spikes of all of them (in order) to 'out_spikes'
+	void step( std::vector<int> * out_spikes = nullptr ) override;
+	// See cpu::snn::run(). 'n_steps' must be a multiple of delay().
+	template <typename Sink>
+	void run( int_ n_steps, Sink && sink )
+	{
+		spice_assert( n_steps % this->delay() == 0, "partitions advance delay() steps at a time" );
+
+		for( int_ i = 0; i < n_steps; i += this->delay() )
+		{
+			_advance();
+			for( int_ j = 0; j < this->delay(); j++ )
+				this->_step(
+				    [&]( int_ const istep, float ) { sink( istep, _exchange( istep, j ) ); } );
+		}
+	}
+	void run( int_ n_steps ) { run( n_steps, []( int_, nonstd::span<int const> ) {} ); }
+
+	size_ num_neurons() const override;
+	size_ num_synapses() const override;
+
+	std::pair<std::vector<int>, size_> adj() const override;
+	std::vector<typename Model::neuron::tuple_t> neurons() const override;
+	std::vector<typename Model::synapse::tuple_t> synapses() const override;
+
+private:
+	util::thread_pool _pool; // 1 thread per partition (+1 idle one for the caller if numa)
+	std::vector<std::unique_ptr<cpu::snn<Model>>> _nets;
+	// partition x delay, spikes emitted during the current batch of steps
+	std::vector<std::vector<std::vector<int>>> _spikes;
+	std::vector<int> _merged;
+
+	// Simulates delay() steps of every partition
+	void _advance();
+	// Shares the spikes partitions emitted during the i-th of the last delay() steps ('istep')
+	// with each other, @return them
+	nonstd::span<int const> _exchange( int_ istep, int_ i );
+
+	// Invokes 'f( ipart )' for every partition, each on its own thread
+	template <typename F>
+	void _run( F && f );
+};
+} // namespace spice::cpu
@@ -1,12 +1,25 @@
 #pragma once
 
 #include <spice/cpu/backend.h>
+#include <spice/cpu/util/hbuffer.h>
+#include <spice/cpu/util/thread_pool.h>
+#include <spice/models/model.h>
 #include <spice/snn.h>
+#include <spice/util/adj_file.h>
 #include <spice/util/adj_list.h>
+#include <spice/util/circular_buffer.h>
+#include <spice/util/mapped_file.h>
+#include <spice/util/packed_adj_list.h>
+#include <spice/util/procedural_adj_list.h>
 #include <spice/util/meta.h>
+#include <spice/util/propagator.h>
 #include <spice/util/span.hpp>
+#include <spice/util/span2d.h>
 
+#include <array>
+#include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 
@@ -18,10 +31,89 @@ template <typename Model>
 class snn : public ::spice::snn<Model>
 {
 public:
-	snn( util::layout const & desc, float dt, int_ delay = 1 );
+	// 'seed' == 0 picks a new seed for every network. For a given seed, results do not depend on
+	// 'num_threads'.
+	// Connections without a delay of their own (see util::layout) use 'delay'. If delays differ
+	// between connections, delay() returns the smallest one and every spike is delivered along
+	// each connection as soon as that connection's delay has passed.
+	// 'transpose' additionally stores incoming edges, allowing receive to pull spikes into their
+	// destinations when activity is dense. Does not affect results. Requires uniform delays,
+	// as do models with synapse state.
+	// 'compress' additionally stores a compressed copy of the graph (see util::packed_adj_list)
+	// which receive decodes on the fly, trading decode time for fewer bytes read when pushing
+	// spikes. Experimental and off by default: it has not yet been measured to be faster (see
+	// spice_bench/compressed_receive.cpp). Does not affect results.
+	// 'procedural' does not store the graph at all but regenerates a neuron's edges from the seed
+	// whenever it spikes (see util::procedural_adj_list), cutting adjacency memory to O(1) per
+	// neuron at the expense of compute. Only supported by models without synapse state, excludes
+	// 'transpose' and 'compress'. Does not affect results.
+	snn( spice::util::layout const & desc,
+	     float dt,
+	     int_ delay = 1,
+	     int_ num_threads = 1,
+	     ulong_ seed = 0,
+	     bool transpose = false,
+	     bool compress = false,
+	     bool procedural = false );
+	// Partition of a network, only simulates neurons [range.first, range.second) (and only stores
+	// edges into this range). range.first must be a multiple of 64, so must range.second unless it
+	// equals desc.size(). Partitions exchange spikes via set_spikes(), see cpu::multi_snn.
+	snn( spice::util::layout const & desc,
+	     float dt,
+	     int_ delay,
+	     std::pair<size_, size_> range,
+	     int_ num_threads = 1,
+	     ulong_ seed = 0,
+	     bool transpose = false,
+	     bool compress = false,
+	     bool procedural = false );
+	// Simulates a prebuilt graph (ELL or CSR, every neuron's neighbors sorted in ascending order)
+	// instead of generating one. The graph is copied.
+	snn( spice::util::adj_list const & adj,
+	     float dt,
+	     int_ delay = 1,
+	     int_ num_threads = 1,
+	     ulong_ seed = 0,
+	     bool transpose = false,
+	     bool compress = false );
+	// Simulates the graph stored in 'graph'. CSR graphs are used in place, straight from the
+	// mapping, ELL ones are converted to CSR. Networks created from the same file share its pages.
+	snn( spice::util::adj_file const & graph,
+	     float dt,
+	     int_ delay = 1,
+	     int_ num_threads = 1,
+	     ulong_ seed = 0,
+	     bool transpose = false,
+	     bool compress = false );
+	// Restores a network from a checkpoint written by save(). Large arrays (graph, neurons,
+	// synapses, spikes) are mapped rather than read: pages are loaded on first access and copied
+	// on first write, the file itself is never modified. Results do not depend on 'num_threads',
+	// 'transpose' or 'compress', so they may differ from the original network's.
+	explicit snn(
+	    std::string const & checkpoint,
+	    int_ num_threads = 1,
+	    bool transpose = false,
+	    bool compress = false );
 
 	void step( std::vector<int> * out_spikes = nullptr ) override;
+	// Simulates 'n_steps' steps in a tight loop (no virtual calls, no copies) and passes the
+	// spikes of every step to 'sink( istep, nonstd::span<int const> spikes )'. 'spikes' is only
+	// valid for the duration of the call.
+	template <typename Sink>
+	void run( int_ n_steps, Sink && sink )
+	{
+		for( int_ i = 0; i < n_steps; i++ )
+			this->_step(
+			    [&]( int_ const istep, float const dt ) { sink( istep, _advance( istep, dt ) ); } );
+	}
+	void run( int_ n_steps ) { run( n_steps, []( int_, nonstd::span<int const> ) {} ); }
+	// Replaces the spikes emitted during 'istep' (one of the last delay() steps, not yet
+	// delivered by any connection) with 'spikes' (sorted). Partitions use it to share their spikes.
+	void set_spikes( int_ istep, nonstd::span<int const> spikes );
 
+	// The graph is stored in CSR format internally. For compatibility with the other backends,
+	// adj() and synapses() present it in (padded) ELL format, num_synapses() counts actual edges.
+	// Partitions return all neurons' (outgoing edges into their range) but only their own neurons.
 	size_ num_neurons() const override;
 	size_ num_synapses() const override;
 	// (edges, width)
@@ -29,23 +121,135 @@ public:
 	std::vector<typename Model::neuron::tuple_t> neurons() const override;
 	std::vector<typename Model::synapse::tuple_t> synapses() const override;
 
+	void save( std::string const & path ) const override;
+
 private:
-	std::optional<std::vector<typename Model::neuron::tuple_t>> _neurons;
-	std::optional<std::vector<typename Model::synapse::tuple_t>> _synapses;
+	// range of neurons simulated by this (partition of a) network
+	size_ const _first;
+	size_ const _last;
+
+	spice::util::soa_t<util::hbuffer, typename Model::neuron> _neurons;
+	spice::util::soa_t<util::hbuffer, typename Model::synapse> _synapses;
+	// (opt.) per-neuron input accumulators, see spice::neuron
+	spice::util::soa_t<util::hbuffer, typename Model::neuron::input> _inputs;
+	// integrates the neurons' linear dynamics over dt(), see spice::neuron
+	spice::util::propagator_t<typename Model::neuron> _propagator;
+	// info() along with the model's constants, passed to all callbacks
+	spice::info_t<Model> _info;
 	struct
 	{
+		// CSR (empty if procedural or mapped from an adj_file or a checkpoint)
 		std::vector<int> edges;
-		util::adj_list adj;
+		std::vector<size_> offsets;
+		// (opt.) keeps the mapping backing 'adj' alive
+		std::optional<spice::util::adj_file> file;
+		// view of the CSR graph, always valid (but without edges if 'procedural' is set)
+		spice::util::adj_list adj;
+		// (opt.) regenerates edges on demand instead of storing them
+		std::optional<spice::util::procedural_adj_list> procedural;
+		// (opt.) compressed copy of 'adj', used by receive
+		std::optional<spice::util::packed_adj_list> packed;
+		// (opt.) transposed CSR, incoming edges sorted by source
+		std::vector<size_> in_offsets;
+		std::vector<int> in_srcs;
+		std::vector<uint_> in_syns;
+		// (plast. only) per neuron, first step whose synapse updates are still pending
+		util::hbuffer<int> ages;
 	} _graph;
 
 	struct
 	{
-		std::vector<int> ids;
-		std::vector<size_> counts;
-		std::optional<std::vector<std::vector<bool>>> flags;
+		// MAX_DELAY() x num_neurons, row i holds the spikes emitted during step i (mod MAX_DELAY())
+		util::hbuffer<int> ids_data;
+		spice::util::span2d<int> ids;
+		spice::util::circular_buffer<size_> counts;
+
+		// (plast. only) MAX_HISTORY() x ceil(num_neurons / 32), row i holds the spike flags of
+		// step i (mod MAX_HISTORY()), 1 bit per neuron
+		util::hbuffer<uint_> history_data;
+		spice::util::span2d<uint_> history;
+		// (plast. only) dt of step i (mod MAX_HISTORY()), so lazy updates match eager ones exactly
+		spice::util::circular_buffer<float> dts;
+
+		// (transpose only) spikes being received, 1 bit per neuron
+		util::hbuffer<uint_> flags;
+
+		// per-thread spike lists, concatenated into 'ids' after each update
+		std::vector<std::vector<int>> local;
+		// (plast. only) per-thread lists of neurons whose history is about to overflow
+		std::vector<std::vector<int>> updates;
+
+		// (procedural only) first destination owned by every thread during receive, + _last
+		std::vector<int> owners;
+		// (procedural only) [t * num_threads + d] holds the (synapse, source, destination) of all
+		// edges which thread t sampled from its spikes and which thread d delivers
+		std::vector<std::vector<std::array<int, 3>>> edges;
 	} _spikes;
 
-	backend _backend;
+	// Heterogeneous delays. The spikes of every step are sorted into one bucket per delay class
+	// (the spikes of sources which have at least one connection of that delay), each of which is
+	// delivered (only to the destinations reached via connections of that delay) once its delay
+	// has passed.
+	struct
+	{
+		// 5 ints per connection of the layout (restricted to this partition's destinations):
+		// src first, src last, dst first, dst last, delay
+		std::vector<int> connections;
+		// distinct delays, ascending; a single one (== delay()) if delays are uniform
+		std::vector<int> classes;
+		// (non-uniform only) source ranges, [sources[g], sources[g + 1]) is group g
+		std::vector<int> sources;
+		// (non-uniform only) destination ranges, group g reaches [targets[t].first,
+		// targets[t].second) via delay class k for t in
+		// [offsets[g * K + k], offsets[g * K + k + 1])
+		std::vector<size_> offsets;
+		std::vector<std::pair<int, int>> targets;
+		// (non-uniform only) MAX_DELAY() x K, [i * K + k] holds the spikes emitted during step i
+		// (mod MAX_DELAY()) by sources with connections of class k
+		std::vector<std::vector<int>> wheel;
+	} _delays;
+
+	util::thread_pool _pool;
+	// one per worker thread
+	std::vector<backend> _backends;
+	// Receive: split spikes among threads (atomics) instead of destinations
+	bool _scatter = false;
+
+	// (restored networks only) backs the graph and, until written to, all other large arrays
+	std::shared_ptr<spice::util::mapped_file> _checkpoint;
+
+	snn( spice::util::adj_list const & adj,
+	     std::optional<spice::util::adj_file> file,
+	     float dt,
+	     int_ delay,
+	     int_ num_threads,
+	     ulong_ seed,
+	     bool transpose,
+	     bool compress );
+	snn( std::shared_ptr<spice::util::mapped_file> checkpoint,
+	     int_ num_threads,
+	     bool transpose,
+	     bool compress );
+	// Allocates the spikes and state of the graph in _graph.adj, calls _init() and initializes
+	// all neurons and synapses
+	void _create( ulong_ seed, int_ num_threads, bool transpose, bool compress );
+	// Creates backends and thread-local buffers, (opt.) transposes and compresses the graph
+	void _init( ulong_ seed, int_ num_threads, bool transpose, bool compress );
+	// Sets up _delays from 'connections' (see _delays.connections)
+	void _init_delays( std::vector<int> connections );
+	// (non-uniform only) sorts the spikes emitted during 'istep' into the wheel
+	void _fill_wheel( int_ istep );
+
+	// Simulates step 'istep', @return the spikes it emitted
+	nonstd::span<int const> _advance( int_ istep, float dt );
+
+	int_ MAX_HISTORY() const;
+	// largest delay of any connection
+	int_ MAX_DELAY() const;
+	// width of the ELL representation returned by adj()
+	size_ ELL_WIDTH() const;
+	// (plast. only) @return whether neuron i spiked during step istep (must still be in history)
+	bool spiked( int_ istep, int_ i ) const;
 };
 } // namespace cpu
 } // namespace spice
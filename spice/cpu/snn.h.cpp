@@ -1,31 +1,98 @@
 #include "snn.h"
 
+#include <spice/cpu/util/ell.h>
 #include <spice/models/brunel.h>
+#include <spice/models/brunel_with_inputs.h>
 #include <spice/models/brunel_with_plasticity.h>
 #include <spice/models/synth.h>
 #include <spice/models/vogels_abbott.h>
 #include <spice/util/assert.h>
+#include <spice/util/circular_buffer.h>
 #include <spice/util/random.h>
 #include <spice/util/type_traits.h>
 
 #include <algorithm>
-#include <future>
+#include <cstdio>
+#include <cstring>
+#include <limits>
 #include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
 
 
-static ulong_ seed = 1337;
+static ulong_ _seed = 1337;
+// Receive pulls (instead of pushes) spikes once more than 1 in PULL_RATIO neurons spiked
+static int_ const PULL_RATIO = 16;
 
 
 using namespace spice::util;
 
 
-template <typename T, bool Const = false>
+// Checkpoint files consist of this header followed by a no. of sections (arrays), each aligned to
+// PAGE_SIZE so they can be mapped straight into hbuffers.
+struct checkpoint_header
+{
+	char magic[8];
+	uint_ version;
+	// guard against restoring a checkpoint into the wrong model
+	uint_ neuron_attrs;
+	uint_ neuron_bytes;
+	uint_ synapse_attrs;
+	uint_ synapse_bytes;
+
+	int_ delay;
+	float dt;
+	int_ num_steps;
+	float simtime;
+	float simtime_residue;
+	ulong_ seed;
+
+	ulong_ num_neurons;
+	ulong_ first;
+	ulong_ last;
+	ulong_ num_edges;
+
+	ulong_ num_sections;
+	struct
+	{
+		ulong_ offset;
+		ulong_ size;
+	} sections[32];
+};
+
+static char const CHECKPOINT_MAGIC[8] = "SPICECP";
+static uint_ const CHECKPOINT_VERSION = 2;
+static size_ const PAGE_SIZE = 4096;
+
+template <typename Model>
+static checkpoint_header const & header_of( mapped_file const & checkpoint )
+{
+	spice_assert( checkpoint.size() >= sizeof( checkpoint_header ), "not a checkpoint" );
+
+	auto const & h = *reinterpret_cast<checkpoint_header const *>( checkpoint.data() );
+	spice_assert( !std::memcmp( h.magic, CHECKPOINT_MAGIC, 8 ), "not a checkpoint" );
+	spice_assert( h.version == CHECKPOINT_VERSION, "unsupported checkpoint version" );
+	spice_assert(
+	    h.neuron_attrs == Model::neuron::size && h.neuron_bytes == Model::neuron::size_in_bytes &&
+	        h.synapse_attrs == Model::synapse::size &&
+	        h.synapse_bytes == Model::synapse::size_in_bytes,
+	    "checkpoint of a different model" );
+
+	return h;
+}
+
+
+// Accesses the attributes of the i-th neuron/synapse via a tuple of per-attribute arrays (SoA)
+// which store elements [first, ...)
+template <typename PTuple, bool Const = false>
 class iter
 {
 public:
-	iter( T * data, size_ i )
-	    : _data( data )
+	iter( PTuple const & data, size_ i, size_ first = 0 )
+	    : _data( &data )
 	    , _i( i )
+	    , _first( first )
 	{
 	}
 
@@ -34,24 +101,23 @@ public:
 	template <int_ I, bool C = Const>
 	auto const & get( typename std::enable_if_t<C> * dummy = 0 )
 	{
-		spice_assert( _data );
-		return std::get<I>( _data[_i] );
+		return std::get<I>( *_data )[_i - _first];
 	}
 
 	template <int_ I, bool C = Const>
 	auto & get( typename std::enable_if_t<!C> * dummy = 0 )
 	{
-		spice_assert( _data );
-		return std::get<I>( _data[_i] );
+		return std::get<I>( *_data )[_i - _first];
 	}
 
 private:
-	T * _data = nullptr;
+	PTuple const * _data = nullptr;
 	size_ _i = 0;
+	size_ _first = 0;
 };
 
-template <typename T>
-using const_iter = iter<T, true>;
+template <typename PTuple>
+using const_iter = iter<PTuple, true>;
 
 
 template <typename F, typename ID>
@@ -68,44 +134,563 @@ static void for_each( F && f, int_ const count, ID && id, adj_list const & adj )
 }
 
 
+template <typename Tuple>
+struct is_integral_tuple;
+template <typename... T>
+struct is_integral_tuple<std::tuple<T...>> : std::bool_constant<( std::is_integral_v<T> && ... )>
+{
+};
+
+
+// Same as above, but only visits edges whose destination lies in [first, last).
+// Relies on neighbors being sorted.
+template <typename F, typename ID>
+static void for_each(
+    F && f, int_ const count, ID && id, adj_list const & adj, int_ const first, int_ const last )
+{
+	for( int_ i = 0; i < count; i++ )
+	{
+		int_ const src = std::forward<ID>( id )( i );
+
+		auto const row = adj.neighbors( src );
+		auto const a = std::lower_bound( row.begin(), row.end(), first );
+		auto const b = std::lower_bound( a, row.end(), last );
+
+		for( auto it = a; it != b; ++it )
+			std::forward<F>( f )(
+			    narrow<uint_>( adj.edge_index( src, it - row.begin() ) ), src, *it );
+	}
+}
+
+
+// Same as above, for graphs which produce their neighbors on the fly (packed_adj_list,
+// procedural_adj_list)
+template <typename F, typename ID, typename Graph>
+static void for_each(
+    F && f,
+    int_ const count,
+    ID && id,
+    Graph const & adj,
+    int_ const first = 0,
+    int_ const last = std::numeric_limits<int_>::max() )
+{
+	for( int_ i = 0; i < count; i++ )
+	{
+		int_ const src = std::forward<ID>( id )( i );
+
+		adj.for_each_neighbor(
+		    src,
+		    [&]( size_ const j, int_ const dst ) {
+			    std::forward<F>( f )( narrow<uint_>( adj.edge_index( src, j ) ), src, dst );
+		    },
+		    first,
+		    last );
+	}
+}
+
+
+// Lazily applies all pending synapse updates of 'src' for steps [age, last) and advances 'age'.
+// 'history( k, i )' returns whether neuron i spiked during step k.
+template <typename Model, typename SynPTuple, typename History>
+static void update_synapses(
+    int_ const src,
+    int_ const last,
+    int_ & age,
+    SynPTuple const & synapses,
+    History && history,
+    circular_buffer<float> const & dts,
+    adj_list const & adj,
+    int_ const delay,
+    spice::info_t<Model> const & info,
+    spice::backend & bak )
+{
+	for_each(
+	    [&]( int_ syn, int_, int_ dst ) {
+		    for( int_ k = age; k < last; k++ )
+		    {
+			    bak.seek( spice::backend::synapse_update, syn, k );
+			    Model::synapse::template update(
+			        iter( synapses, syn ),
+			        src,
+			        dst,
+			        history( k - delay, src ),
+			        history( k, dst ),
+			        dts[k],
+			        info,
+			        bak );
+		    }
+	    },
+	    1,
+	    [src]( int_ ) { return src; },
+	    adj );
+
+	age = last;
+}
+
+// @return g such that sources[g] <= src < sources[g + 1]
+static size_ source_of( std::vector<int> const & sources, int_ const src )
+{
+	return std::upper_bound( sources.begin(), sources.end(), src ) - sources.begin() - 1;
+}
+
+
 namespace spice::cpu
 {
 template <typename Model>
-snn<Model>::snn( layout const & desc, float const dt, int_ const delay /* = 1 */ )
+int_ snn<Model>::MAX_HISTORY() const
+{
+	// A neuron's synapses are brought up to date at the latest every MAX_HISTORY() - delay steps
+	return this->delay() + 32;
+}
+
+template <typename Model>
+int_ snn<Model>::MAX_DELAY() const
+{
+	return _delays.classes.back();
+}
+
+template <typename Model>
+size_ snn<Model>::ELL_WIDTH() const
+{
+	return util::ell_width( _graph.adj.max_degree() );
+}
+
+template <typename Model>
+bool snn<Model>::spiked( int_ const istep, int_ const i ) const
+{
+	return istep >= 0 &&
+	       _spikes.history( circidx( istep, MAX_HISTORY() ), i / 32 ) >> ( i % 32 ) & 1u;
+}
+
+template <typename Model>
+snn<Model>::snn(
+    layout const & desc,
+    float const dt,
+    int_ const delay /* = 1 */,
+    int_ const num_threads /* = 1 */,
+    ulong_ const seed /* = 0 */,
+    bool const transpose /* = false */,
+    bool const compress /* = false */,
+    bool const procedural /* = false */ )
+    : snn( desc, dt, delay, { 0, desc.size() }, num_threads, seed, transpose, compress, procedural )
+{
+}
+
+template <typename Model>
+snn<Model>::snn(
+    layout const & desc,
+    float const dt,
+    int_ const delay,
+    std::pair<size_, size_> const range,
+    int_ const num_threads /* = 1 */,
+    ulong_ seed /* = 0 */,
+    bool const transpose /* = false */,
+    bool const compress /* = false */,
+    bool const procedural /* = false */ )
+    : ::spice::snn<Model>( dt, desc.min_delay( delay ) )
+    , _first( range.first )
+    , _last( range.second )
+    , _pool( num_threads )
+{
+	spice_assert( dt > 0.0f );
+	spice_assert( delay >= 1 );
+	spice_assert( _first <= _last && _last <= desc.size(), "invalid range" );
+	spice_assert( _first % 64 == 0 && ( _last % 64 == 0 || _last == desc.size() ), "misaligned" );
+	spice_assert(
+	    Model::synapse::size == 0 || desc.min_delay( delay ) == desc.max_delay( delay ),
+	    "plasticity requires uniform delays" );
+
+	if( !seed ) seed = hash( _seed++ );
+
+	// Only edges into [_first, _last)
+	if( procedural )
+	{
+		spice_assert( Model::synapse::size == 0, "procedural graphs require stateless synapses" );
+		spice_assert( !transpose && !compress, "procedural graphs are never stored" );
+
+		_graph.procedural.emplace( desc.cut( range ).part, seed, num_threads );
+		_graph.adj = { desc.size(), _graph.procedural->offsets(), nullptr };
+	}
+	else
+	{
+		adj_list::generate(
+		    desc.cut( range ).part, _graph.edges, _graph.offsets, seed, num_threads );
+		_graph.adj = { desc.size(), _graph.offsets.data(), _graph.edges.data() };
+	}
+
+	{
+		auto const part = desc.cut( range ).part;
+
+		std::vector<int> connections;
+		for( size_ i = 0; i < part.connections().size(); i++ )
+		{
+			auto const [a, b, c, d, p] = part.connections()[i];
+			connections.insert(
+			    connections.end(), { a, b, c, d, part.delays()[i] ? part.delays()[i] : delay } );
+		}
+		_init_delays( std::move( connections ) );
+	}
+
+	_create( seed, num_threads, transpose, compress );
+}
+
+template <typename Model>
+snn<Model>::snn(
+    adj_list const & adj,
+    float const dt,
+    int_ const delay /* = 1 */,
+    int_ const num_threads /* = 1 */,
+    ulong_ const seed /* = 0 */,
+    bool const transpose /* = false */,
+    bool const compress /* = false */ )
+    : snn( adj, std::nullopt, dt, delay, num_threads, seed, transpose, compress )
+{
+}
+
+template <typename Model>
+snn<Model>::snn(
+    adj_file const & graph,
+    float const dt,
+    int_ const delay /* = 1 */,
+    int_ const num_threads /* = 1 */,
+    ulong_ const seed /* = 0 */,
+    bool const transpose /* = false */,
+    bool const compress /* = false */ )
+    : snn( graph.adj(), graph, dt, delay, num_threads, seed, transpose, compress )
+{
+}
+
+template <typename Model>
+snn<Model>::snn(
+    adj_list const & adj,
+    std::optional<adj_file> file,
+    float const dt,
+    int_ const delay,
+    int_ const num_threads,
+    ulong_ seed,
+    bool const transpose,
+    bool const compress )
     : ::spice::snn<Model>( dt, delay )
-    , _backend( seed++ )
+    , _first( 0 )
+    , _last( adj.num_nodes() )
+    , _pool( num_threads )
 {
 	spice_assert( dt > 0.0f );
 	spice_assert( delay >= 1 );
 
+	if( !seed ) seed = hash( _seed++ );
+
+	size_ const N = adj.num_nodes();
+	if( file && adj.offsets() )
+	{
+		// Used in place (adj_file validates graphs when opening them)
+		_graph.file = std::move( file );
+		_graph.adj = adj;
+	}
+	else
+	{
+		// Copy (and convert ELL) to CSR
+		_graph.offsets.resize( N + 1 );
+		_graph.offsets[0] = 0;
+		for( size_ i = 0; i < N; i++ )
+		{
+			auto const row = adj.neighbors( i );
+			bool const valid =
+			    std::is_sorted( row.begin(), row.end() ) &&
+			    ( row.empty() || ( row[0] >= 0 && row[row.size() - 1] < narrow<int>( N ) ) );
+			spice_assert( valid, "neighbors must be sorted and within bounds" );
+
+			_graph.edges.insert( _graph.edges.end(), row.begin(), row.end() );
+			_graph.offsets[i + 1] = _graph.edges.size();
+		}
+		_graph.adj = { N, _graph.offsets.data(), _graph.edges.data() };
+	}
+
+	_init_delays( { 0, narrow<int>( N ), 0, narrow<int>( N ), delay } );
+	_create( seed, num_threads, transpose, compress );
+}
+
+template <typename Model>
+void snn<Model>::_create(
+    ulong_ const seed, int_ const num_threads, bool const transpose, bool const compress )
+{
+	size_ const N = num_neurons();
+
+	_spikes.ids_data.resize( MAX_DELAY() * N );
+	_spikes.ids = { _spikes.ids_data.data(), narrow<int>( N ) };
+	_spikes.counts = circular_buffer<size_>( MAX_DELAY() );
+
+	if constexpr( Model::synapse::size > 0 )
 	{
-		adj_list::generate( desc, _graph.edges );
-		_graph.adj = { desc.size(), desc.max_degree(), _graph.edges.data() };
+		_spikes.history_data.resize( MAX_HISTORY() * ( ( N + 31 ) / 32 ) );
+		_spikes.history = { _spikes.history_data.data(), narrow<int>( ( N + 31 ) / 32 ) };
+		_spikes.dts = circular_buffer<float>( MAX_HISTORY() );
+
+		_graph.ages.resize( N );
 	}
 
+	_init( seed, num_threads, transpose, compress );
+
+	auto const & info = _info;
+
 	// Init neurons
 	if constexpr( Model::neuron::size > 0 )
 	{
-		_neurons.emplace( desc.size() );
-		for( size_ i = 0; i < desc.size(); i++ )
-			Model::neuron::template init( iter( _neurons->data(), i ), this->info(), _backend );
+		_neurons.resize( _last - _first );
+		auto const neurons = _neurons.data();
+		_pool.parallel_for( _last - _first, [&]( size_ first, size_ last, int_ ithread ) {
+			auto & bak = _backends[ithread];
+			for( size_ i = first; i < last; i++ )
+			{
+				bak.seek( backend::neuron_init, narrow<uint_>( _first + i ) );
+				Model::neuron::template init( iter( neurons, _first + i, _first ), info, bak );
+			}
+		} );
 	}
 
 	// Init synapses
 	if constexpr( Model::synapse::size > 0 )
 	{
-		_synapses.emplace( _graph.adj.num_edges() );
+		_synapses.resize( _graph.adj.num_edges() );
+		auto const synapses = _synapses.data();
+		_pool.parallel_for( N, [&]( size_ first, size_ last, int_ ithread ) {
+			for_each(
+			    [&, &bak = _backends[ithread]]( uint_ syn, int_ src, int_ dst ) {
+				    bak.seek( backend::synapse_init, syn );
+				    Model::synapse::template init( iter( synapses, syn ), src, dst, info, bak );
+			    },
+			    narrow<int>( last - first ),
+			    [first]( int_ x ) { return narrow<int>( first ) + x; },
+			    _graph.adj );
+		} );
+	}
+}
+
+template <typename Model>
+snn<Model>::snn(
+    std::string const & checkpoint,
+    int_ const num_threads /* = 1 */,
+    bool const transpose /* = false */,
+    bool const compress /* = false */ )
+    : snn( std::make_shared<mapped_file>( checkpoint ), num_threads, transpose, compress )
+{
+}
+
+template <typename Model>
+snn<Model>::snn(
+    std::shared_ptr<mapped_file> checkpoint,
+    int_ const num_threads,
+    bool const transpose,
+    bool const compress )
+    : ::spice::snn<Model>(
+          header_of<Model>( *checkpoint ).dt, header_of<Model>( *checkpoint ).delay )
+    , _first( header_of<Model>( *checkpoint ).first )
+    , _last( header_of<Model>( *checkpoint ).last )
+    , _pool( num_threads )
+    , _checkpoint( checkpoint )
+{
+	auto const & h = header_of<Model>( *checkpoint );
+	size_ isection = 0;
+	// @return the next section, which must hold 'n' elements of type T
+	auto const next = [&]( auto * type, size_ const n ) {
+		using T = std::remove_pointer_t<decltype( type )>;
+
+		spice_assert( isection < h.num_sections && h.sections[isection].size == n * sizeof( T ) );
+		auto const s = h.sections[isection++];
+		spice_assert( s.offset + s.size <= checkpoint->size(), "truncated checkpoint" );
+
+		return reinterpret_cast<T *>( checkpoint->data() + s.offset );
+	};
+	// Adopts the next section into 'buf'
+	auto const adopt = [&]( auto & buf, size_ const n ) {
+		using T = std::remove_reference_t<decltype( *buf.data() )>;
+		buf = util::hbuffer<T>( next( (T *)nullptr, n ), n, checkpoint );
+	};
+
+	size_ const N = h.num_neurons;
+	size_ const * const offsets = next( (size_ *)nullptr, N + 1 );
+	int_ const * const edges = next( (int_ *)nullptr, h.num_edges );
+	spice_assert( offsets[N] == h.num_edges, "corrupt checkpoint" );
+	_graph.adj = { N, offsets, edges };
+	{
+		size_ const n = isection < h.num_sections ? h.sections[isection].size / sizeof( int_ ) : 0;
+		int_ const * const connections = next( (int_ *)nullptr, n );
+		spice_assert( n % 5 == 0, "corrupt checkpoint" );
+		_init_delays( { connections, connections + n } );
+	}
+
+	adopt( _spikes.ids_data, MAX_DELAY() * N );
+	_spikes.ids = { _spikes.ids_data.data(), narrow<int>( N ) };
+	{
+		size_ const * const counts = next( (size_ *)nullptr, MAX_DELAY() );
+		_spikes.counts = circular_buffer<size_>( MAX_DELAY() );
+		for( int_ i = 0; i < MAX_DELAY(); i++ ) _spikes.counts[i] = counts[i];
+	}
+
+	if constexpr( Model::synapse::size > 0 )
+	{
+		adopt( _spikes.history_data, MAX_HISTORY() * ( ( N + 31 ) / 32 ) );
+		_spikes.history = { _spikes.history_data.data(), narrow<int>( ( N + 31 ) / 32 ) };
+
+		float const * const dts = next( (float *)nullptr, MAX_HISTORY() );
+		_spikes.dts = circular_buffer<float>( MAX_HISTORY() );
+		for( int_ i = 0; i < MAX_HISTORY(); i++ ) _spikes.dts[i] = dts[i];
+
+		adopt( _graph.ages, N );
+	}
+
+	_neurons.for_each_attr( [&]( auto & buf ) { adopt( buf, _last - _first ); } );
+	_synapses.for_each_attr( [&]( auto & buf ) { adopt( buf, h.num_edges ); } );
+	spice_assert( isection == h.num_sections, "corrupt checkpoint" );
+
+	this->_set_clock( h.num_steps, { h.simtime, h.simtime_residue } );
+
+	_init( h.seed, num_threads, transpose, compress );
+
+	// Spikes not yet delivered by every connection
+	for( int_ i = std::max( 0, h.num_steps - MAX_DELAY() ); i < h.num_steps; i++ ) _fill_wheel( i );
+}
+
+template <typename Model>
+void snn<Model>::_init(
+    ulong_ const seed, int_ const num_threads, bool const transpose, bool const compress )
+{
+	spice_assert( !transpose || _delays.classes.size() == 1, "transpose requires uniform delays" );
+
+	// All backends share the same seed, see backend::seek()
+	_backends.assign( num_threads, backend( seed ) );
+
+	// Integer state (or input) is indifferent to the order in which spikes are delivered. This
+	// allows splitting receive by source, which avoids every thread having to scan every spike.
+	using received_t = std::conditional_t<
+	    ( Model::neuron::input::size > 0 ),
+	    typename Model::neuron::input::tuple_t,
+	    typename Model::neuron::tuple_t>;
+	_scatter = num_threads > 1 && is_integral_tuple<received_t>::value;
+
+	// Inputs are consumed by every step, so they are never part of a checkpoint
+	_inputs.resize( _last - _first );
+	_info = make_info<Model>( this->info() );
+	_propagator = { Model::neuron::dynamics( _info ), this->dt() };
+
+	_spikes.local.resize( num_threads );
+	if constexpr( Model::synapse::size > 0 ) _spikes.updates.resize( num_threads );
+	if( _graph.procedural )
+	{
+		for( int_ t = 0; t < num_threads; t++ )
+			_spikes.owners.push_back( narrow<int>(
+			    _first + util::thread_pool::chunk( _last - _first, num_threads, t, 64 ).first ) );
+		_spikes.owners.push_back( narrow<int>( _last ) );
+		_spikes.edges.resize( num_threads * num_threads );
+	}
+
+	if( compress ) _graph.packed.emplace( _graph.adj );
+
+	if( transpose )
+	{
+		size_ const N = num_neurons();
+		size_ const E = _graph.adj.num_edges();
+
+		// Counting sort by destination, visiting sources in ascending order
+		_graph.in_offsets.assign( N + 1, 0 );
+		for( size_ i = 0; i < E; i++ ) _graph.in_offsets[_graph.adj.edges()[i] + 1]++;
+		std::partial_sum(
+		    _graph.in_offsets.begin(), _graph.in_offsets.end(), _graph.in_offsets.begin() );
+
+		_graph.in_srcs.resize( E );
+		_graph.in_syns.resize( E );
+
+		std::vector<size_> pos( _graph.in_offsets.begin(), _graph.in_offsets.end() - 1 );
 		for_each(
 		    [&]( uint_ syn, int_ src, int_ dst ) {
-			    Model::synapse::template init(
-			        iter( _synapses->data(), syn ), src, dst, this->info(), _backend );
+			    _graph.in_srcs[pos[dst]] = src;
+			    _graph.in_syns[pos[dst]++] = syn;
 		    },
-		    narrow<int>( desc.size() ),
+		    narrow<int>( N ),
 		    []( int_ x ) { return x; },
 		    _graph.adj );
 
-		_spikes.flags.emplace( delay + 1 );
-		for( auto & bitvec : *_spikes.flags ) bitvec.resize( desc.size() );
+		_spikes.flags.resize( ( N + 31 ) / 32 );
+	}
+}
+
+template <typename Model>
+void snn<Model>::_init_delays( std::vector<int> connections )
+{
+	_delays.connections = std::move( connections );
+	auto const & c = _delays.connections;
+
+	_delays.classes.clear();
+	for( size_ i = 0; i < c.size(); i += 5 )
+	{
+		spice_assert( c[i + 4] >= 1, "invalid delay" );
+		_delays.classes.push_back( c[i + 4] );
+	}
+	std::sort( _delays.classes.begin(), _delays.classes.end() );
+	_delays.classes.erase(
+	    std::unique( _delays.classes.begin(), _delays.classes.end() ), _delays.classes.end() );
+	if( _delays.classes.empty() ) _delays.classes.push_back( this->delay() );
+
+	_delays.sources.clear();
+	_delays.offsets.clear();
+	_delays.targets.clear();
+	_delays.wheel.clear();
+
+	size_ const K = _delays.classes.size();
+	if( K == 1 ) return;
+
+	// Split sources into groups which share the same connections
+	_delays.sources = { 0, narrow<int>( num_neurons() ) };
+	for( size_ i = 0; i < c.size(); i += 5 )
+		_delays.sources.insert( _delays.sources.end(), { c[i], c[i + 1] } );
+	std::sort( _delays.sources.begin(), _delays.sources.end() );
+	_delays.sources.erase(
+	    std::unique( _delays.sources.begin(), _delays.sources.end() ), _delays.sources.end() );
+
+	size_ const G = _delays.sources.size() - 1;
+	_delays.offsets.push_back( 0 );
+	for( size_ g = 0; g < G; g++ )
+		for( size_ k = 0; k < K; k++ )
+		{
+			size_ const first = _delays.targets.size();
+			for( size_ i = 0; i < c.size(); i += 5 )
+				if( c[i] <= _delays.sources[g] && _delays.sources[g] < c[i + 1] &&
+				    c[i + 4] == _delays.classes[k] )
+					_delays.targets.push_back( { c[i + 2], c[i + 3] } );
+
+			// Merge adjacent ranges
+			std::sort( _delays.targets.begin() + first, _delays.targets.end() );
+			size_ last = first;
+			for( size_ t = first; t < _delays.targets.size(); t++ )
+				if( last > first && _delays.targets[last - 1].second >= _delays.targets[t].first )
+					_delays.targets[last - 1].second =
+					    std::max( _delays.targets[last - 1].second, _delays.targets[t].second );
+				else
+					_delays.targets[last++] = _delays.targets[t];
+			_delays.targets.resize( last );
+
+			_delays.offsets.push_back( last );
+		}
+
+	_delays.wheel.resize( MAX_DELAY() * K );
+}
+
+template <typename Model>
+void snn<Model>::_fill_wheel( int_ const istep )
+{
+	size_ const K = _delays.classes.size();
+	if( K == 1 ) return;
+
+	int_ const slot = circidx( istep, MAX_DELAY() );
+	for( size_ k = 0; k < K; k++ ) _delays.wheel[slot * K + k].clear();
+
+	int_ const * const spikes = _spikes.ids.row( slot );
+	for( size_ i = 0; i < _spikes.counts[istep]; i++ )
+	{
+		size_ const g = source_of( _delays.sources, spikes[i] );
+		for( size_ k = 0; k < K; k++ )
+			if( _delays.offsets[g * K + k] < _delays.offsets[g * K + k + 1] )
+				_delays.wheel[slot * K + k].push_back( spikes[i] );
 	}
 }
 
@@ -115,72 +700,479 @@ template <typename Model>
 void snn<Model>::step( std::vector<int> * out_spikes )
 {
 	this->_step( [&]( int_ const istep, float const dt ) {
-		int_ const post = istep % ( this->delay() + 1 );
-		int_ const pre = ( istep + 1 ) % ( this->delay() + 1 );
+		auto const spikes = _advance( istep, dt );
+		if( out_spikes ) out_spikes->assign( spikes.begin(), spikes.end() );
+	} );
+}
+
+template <typename Model>
+nonstd::span<int const> snn<Model>::_advance( int_ const istep, float const dt )
+{
+	auto const & info = _info;
+	auto const neurons = _neurons.data();
+	auto const synapses = _synapses.data();
+
+	auto const history = [this]( int_ const k, int_ const i ) { return spiked( k, i ); };
+	// neuron i (global id)
+	auto const neuron = [&]( int_ const i ) { return iter( neurons, i, _first ); };
+	// spikes are received into neuron i's input accumulator if its model has one, else into
+	// its state
+	auto const inputs = _inputs.data();
+	auto const target = [&]( int_ const i ) {
+		if constexpr( Model::neuron::input::size > 0 )
+			return iter( inputs, i, _first );
+		else
+			return neuron( i );
+	};
+
+	// Receive spikes, one delay (class) at a time
+	for( size_ k = 0; k < _delays.classes.size(); k++ )
+	{
+		int_ const delay = _delays.classes[k];
+		if( istep < delay ) continue;
+
+		// All connections share the same delay: deliver all edges of all spikes
+		bool const uniform = _delays.classes.size() == 1;
+		size_ const K = _delays.classes.size();
+		size_ const N = this->num_neurons();
+
+		int_ const slot = circidx( istep - delay, MAX_DELAY() );
+		int_ const * const spikes =
+		    uniform ? _spikes.ids.row( slot ) : _delays.wheel[slot * K + k].data();
+		int_ const nspikes = narrow<int>(
+		    uniform ? _spikes.counts[istep - delay] : _delays.wheel[slot * K + k].size() );
+
+		// Bring the synapses of all spiking neurons up to date (up to and incl. the previous
+		// step) before they deliver their spikes.
+		if constexpr( Model::synapse::size > 0 )
+			_pool.parallel_for( nspikes, [&]( size_ first, size_ last, int_ ithread ) {
+				for( size_ i = first; i < last; i++ )
+					update_synapses<Model>(
+					    spikes[i],
+					    istep,
+					    _graph.ages[spikes[i]],
+					    synapses,
+					    history,
+					    _spikes.dts,
+					    _graph.adj,
+					    this->delay(),
+					    info,
+					    _backends[ithread] );
+			} );
+
+		// Invokes 'f( graph )' with the compressed or procedural graph if there is one, the CSR
+		// one otherwise
+		auto const with_graph = [&]( auto && f ) {
+			if( _graph.packed )
+				f( *_graph.packed );
+			else if( _graph.procedural )
+				f( *_graph.procedural );
+			else
+				f( _graph.adj );
+		};
+
+		// P: src's population
+		auto const deliver = [&]( auto const P, auto & bak, int_ syn, int_ src, int_ dst ) {
+			bak.seek( backend::neuron_receive, syn, istep );
+			receive_spike<typename Model::neuron, decltype( P )::value>(
+			    src,
+			    target( dst ),
+			    const_iter<typename Model::synapse::ptuple_t>( synapses, syn ),
+			    info,
+			    bak );
+		};
+
+		// Receives spikes via 'bak'
+		auto const into = [&]( auto & bak ) {
+			return [&]( auto const P, int_ syn, int_ src, int_ dst ) {
+				deliver( P, bak, syn, src, dst );
+			};
+		};
+
+		// Passes spikes [a, b) via 'adj' to 'to( P, syn, src, dst )' for all their destinations
+		// in [first, last) which they reach via class k
+		auto const push = [&]( auto && to,
+		                       auto const & adj,
+		                       size_ const a,
+		                       size_ const b,
+		                       int_ const first,
+		                       int_ const last ) {
+			// Spikes are sorted, so those of every source population are contiguous and can be
+			// delivered by a single receive<P>() specialization
+			if( uniform )
+				for_each_population<typename Model::neuron>(
+				    narrow<int>( a ),
+				    narrow<int>( b ),
+				    info,
+				    [&]( auto const P, int_ const x0, int_ const x1 ) {
+					    auto const f = [&]( int_ syn, int_ src, int_ dst ) {
+						    to( P, syn, src, dst );
+					    };
 
-		// Receive spikes
-		if( _spikes.counts.size() >= static_cast<uint_>( this->delay() ) )
+					    for_each(
+					        f,
+					        x1 - x0,
+					        [&]( int_ x ) { return spikes[x0 + x]; },
+					        adj,
+					        first,
+					        last );
+				    },
+				    [&]( int_ x ) { return spikes[x]; } );
+			else
+				for( size_ i = a; i < b; i++ )
+				{
+					int_ const src = spikes[i];
+					size_ const g = source_of( _delays.sources, src );
+
+					size_ const t0 = _delays.offsets[g * K + k];
+					size_ const t1 = _delays.offsets[g * K + k + 1];
+					with_population<typename Model::neuron>( src, info, [&]( auto const P ) {
+						auto const f = [&]( int_ syn, int_, int_ dst ) {
+							to( P, syn, src, dst );
+						};
+
+						for( size_ t = t0; t < t1; t++ )
+						{
+							int_ const lo = std::max( first, _delays.targets[t].first );
+							int_ const hi = std::min( last, _delays.targets[t].second );
+							if( lo < hi )
+								for_each( f, 1, [src]( int_ ) { return src; }, adj, lo, hi );
+						}
+					} );
+				}
+		};
+
+		if( uniform && !_graph.in_offsets.empty() && nspikes * PULL_RATIO > narrow<int>( N ) )
 		{
-			for_each(
-			    [&]( int_ syn, int_ src, int_ dst ) {
-				    Model::neuron::template receive(
-				        src,
-				        iter( _neurons->data(), dst ),
-				        const_iter<typename Model::synapse::tuple_t>( _synapses->data(), syn ),
-				        this->info(),
-				        _backend );
+			// Dense activity: Every destination gathers its inputs from the spiking
+			// sources. Incoming edges are sorted by source, so inputs accumulate in the same
+			// order as when pushing.
+			_spikes.flags.zero();
+			for( int_ i = 0; i < nspikes; i++ )
+				_spikes.flags[spikes[i] / 32] |= 1u << ( spikes[i] % 32 );
+
+			_pool.parallel_for(
+			    _last - _first,
+			    [&]( size_ first, size_ last, int_ ithread ) {
+				    auto & bak = _backends[ithread];
+				    for( int_ dst = narrow<int>( _first + first );
+				         dst < narrow<int>( _first + last );
+				         dst++ )
+				    {
+					    size_ const a = _graph.in_offsets[dst];
+					    size_ const b = _graph.in_offsets[dst + 1];
+
+					    for( size_ j = a; j < b; j++ )
+					    {
+						    int_ const src = _graph.in_srcs[j];
+						    if( _spikes.flags[src / 32] >> ( src % 32 ) & 1u )
+							    with_population<typename Model::neuron>(
+							        src, info, [&]( auto const P ) {
+								        deliver( P, bak, _graph.in_syns[j], src, dst );
+							        } );
+					    }
+				    }
 			    },
-			    narrow<int>( _spikes.counts.front() ),
-			    [&]( int_ x ) { return _spikes.ids[x]; },
-			    _graph.adj );
+			    64 );
+		}
+		else if( _scatter )
+		{
+			// Every thread delivers a contiguous range of spikes, using atomics
+			_pool.parallel_for( nspikes, [&]( size_ first, size_ last, int_ ithread ) {
+				atomic_backend bak( _backends[ithread] );
+				with_graph( [&]( auto const & adj ) {
+					push( into( bak ), adj, first, last, 0, std::numeric_limits<int_>::max() );
+				} );
+			} );
+		}
+		else if( _graph.procedural && _pool.size() > 1 )
+		{
+			// Same as below, but sampling every spike's edges only once (rather than once per
+			// thread): Every thread samples a contiguous range of spikes and buckets their edges
+			// by the thread owning their destination, which then delivers its buckets in thread
+			// (and hence spike) order.
+			int_ const T = _pool.size();
+			_pool.run( [&]( int_ const ithread ) {
+				auto const [first, last] = util::thread_pool::chunk( nspikes, T, ithread );
+				auto const buckets = &_spikes.edges[ithread * T];
+				for( int_ t = 0; t < T; t++ ) buckets[t].clear();
 
-			_spikes.ids.erase( _spikes.ids.begin(), _spikes.ids.begin() + _spikes.counts.front() );
-			_spikes.counts.erase( _spikes.counts.begin() );
+				auto const & owners = _spikes.owners;
+				push(
+				    [&]( auto, int_ syn, int_ src, int_ dst ) {
+					    auto const t =
+					        std::upper_bound( owners.begin() + 1, owners.end() - 1, dst ) -
+					        owners.begin() - 1;
+					    buckets[t].push_back( { syn, src, dst } );
+				    },
+				    *_graph.procedural,
+				    first,
+				    last,
+				    owners.front(),
+				    owners.back() );
+			} );
+
+			_pool.run( [&]( int_ const ithread ) {
+				auto & bak = _backends[ithread];
+				for( int_ t = 0; t < T; t++ )
+					for( auto const & e : _spikes.edges[t * T + ithread] )
+						with_population<typename Model::neuron>( e[1], info, [&]( auto const P ) {
+							deliver( P, bak, e[0], e[1], e[2] );
+						} );
+			} );
 		}
+		else
+		{
+			// Every thread owns a contiguous range of destination neurons (the same one it
+			// updates) and visits all spikes in order, delivering only those edges that fall
+			// into its range. This requires no atomics and keeps the accumulation order
+			// deterministic.
+			_pool.run( [&]( int_ const ithread ) {
+				auto const [first, last] =
+				    util::thread_pool::chunk( _last - _first, _pool.size(), ithread, 64 );
+				if( first == last ) return;
 
-		// Update neurons
+				with_graph( [&]( auto const & adj ) {
+					push(
+					    into( _backends[ithread] ),
+					    adj,
+					    0,
+					    nspikes,
+					    narrow<int>( _first + first ),
+					    narrow<int>( _first + last ) );
+				} );
+			} );
+		}
+	}
+
+	// Update neurons
+	{
+		if constexpr( Model::synapse::size > 0 )
 		{
-			auto const nspikes = _spikes.ids.size();
+			_spikes.dts[istep] = dt;
+			for( auto & updates : _spikes.updates ) updates.clear();
+		}
 
-			for( int_ i = 0; i < narrow<int>( this->num_neurons() ); i++ )
-			{
-				bool const spiked = Model::neuron::template update(
-				    iter( _neurons ? _neurons->data() : nullptr, i ), dt, this->info(), _backend );
+		float const udt = update_dt<typename Model::neuron>( dt, this->dt() );
 
-				if constexpr( Model::synapse::size > 0 ) ( *( _spikes.flags ) )[post][i] = spiked;
+		// Next step would overwrite history still needed by i's synapses
+		auto const overflows = [&]( int_ const i ) {
+			return istep + 1 - _graph.ages[i] + this->delay() == MAX_HISTORY();
+		};
 
-				if( spiked ) _spikes.ids.push_back( i );
-			}
+		// Chunks are multiples of 64 neurons so that no two threads ever write to the same
+		// word of the history.
+		_pool.parallel_for(
+		    _last - _first,
+		    [&]( size_ first, size_ last, int_ ithread ) {
+			    auto & spikes = _spikes.local[ithread];
+			    spikes.clear();
 
-			_spikes.counts.push_back( _spikes.ids.size() - nspikes );
-		}
+			    auto & bak = _backends[ithread];
 
-		if( out_spikes && !_spikes.counts.empty() )
-			out_spikes->assign( _spikes.ids.end() - _spikes.counts.back(), _spikes.ids.end() );
+			    // One loop per population (range), each with its own update<P>() specialization
+			    uint_ flags = 0;
+			    for_each_population<typename Model::neuron>(
+			        narrow<int>( _first + first ),
+			        narrow<int>( _first + last ),
+			        info,
+			        [&]( auto const P, int_ const a, int_ const b ) {
+				        constexpr int_ p = decltype( P )::value;
 
-		// Update synapses
-		if constexpr( Model::synapse::size > 0 )
+				        for( int_ i = a; i < b; i++ )
+				        {
+					        bak.seek( backend::neuron_update, i, istep );
+					        bool spiked;
+					        if constexpr( Model::neuron::input::size > 0 )
+					        {
+						        spiked = update_neuron<typename Model::neuron, p>(
+						            neuron( i ), target( i ), udt, info, bak );
+						        spice::util::for_each(
+						            inputs, [&]( auto * in ) { in[i - _first] = {}; } );
+					        }
+					        else
+						        spiked = update_neuron<typename Model::neuron, p>(
+						            neuron( i ), udt, info, bak );
+					        _propagator.apply( neuron( i ) );
+
+					        if constexpr( Model::synapse::size > 0 )
+					        {
+						        flags |= uint_( spiked ) << ( i % 32 );
+						        if( i % 32 == 31 || i + 1 == narrow<int>( _first + last ) )
+						        {
+							        _spikes.history( circidx( istep, MAX_HISTORY() ), i / 32 ) =
+							            flags;
+							        flags = 0;
+						        }
+
+						        if( overflows( i ) ) _spikes.updates[ithread].push_back( i );
+					        }
+
+					        if( spiked ) spikes.push_back( i );
+				        }
+			        } );
+		    },
+		    64 );
+
+		// Overwrites the spikes we just received (MAX_DELAY() steps ago)
+		int_ * const spikes = _spikes.ids.row( circidx( istep, MAX_DELAY() ) );
+
+		size_ nspikes = 0;
+		for( auto const & local : _spikes.local )
 		{
-			for_each(
-			    [&]( int_ syn, int_ src, int_ dst ) {
-				    Model::synapse::template update(
-				        iter( _synapses->data(), syn ),
-				        src,
-				        dst,
-				        ( *_spikes.flags )[pre][src],
-				        ( *_spikes.flags )[post][dst],
-				        dt,
-				        this->info(),
-				        _backend );
-			    },
-			    narrow<int>( this->num_neurons() ),
-			    []( int_ x ) { return x; },
-			    _graph.adj );
+			std::copy( local.begin(), local.end(), spikes + nspikes );
+			nspikes += local.size();
 		}
-	} );
+
+		_spikes.counts[istep] = nspikes;
+		_fill_wheel( istep );
+
+		// Partitions also store the synapses of all other neurons' edges into their range
+		if constexpr( Model::synapse::size > 0 )
+			if( _last - _first < this->num_neurons() )
+				_pool.parallel_for(
+				    this->num_neurons(), [&]( size_ first, size_ last, int_ ithread ) {
+					    for( int_ i = narrow<int>( first ); i < narrow<int>( last ); i++ )
+						    if( ( i < narrow<int>( _first ) || i >= narrow<int>( _last ) ) &&
+						        overflows( i ) )
+							    _spikes.updates[ithread].push_back( i );
+				    } );
+	}
+
+	// Update synapses whose history is about to overflow (incl. the current step)
+	if constexpr( Model::synapse::size > 0 )
+	{
+		_pool.run( [&]( int_ ithread ) {
+			for( int_ src : _spikes.updates[ithread] )
+				update_synapses<Model>(
+				    src,
+				    istep + 1,
+				    _graph.ages[src],
+				    synapses,
+				    history,
+				    _spikes.dts,
+				    _graph.adj,
+				    this->delay(),
+				    info,
+				    _backends[ithread] );
+		} );
+	}
+
+	return { _spikes.ids.row( circidx( istep, MAX_DELAY() ) ), _spikes.counts[istep] };
 }
 #pragma GCC diagnostic pop
 
+template <typename Model>
+void snn<Model>::set_spikes( int_ const istep, nonstd::span<int const> const spikes )
+{
+	spice_assert(
+	    istep < this->_num_steps() && istep >= this->_num_steps() - this->delay(),
+	    "spikes already delivered" );
+	spice_assert( spikes.size() <= num_neurons() );
+
+	std::copy( spikes.begin(), spikes.end(), _spikes.ids.row( circidx( istep, MAX_DELAY() ) ) );
+	_spikes.counts[istep] = spikes.size();
+	_fill_wheel( istep );
+
+	if constexpr( Model::synapse::size > 0 )
+	{
+		uint_ * const row = _spikes.history.row( circidx( istep, MAX_HISTORY() ) );
+
+		std::fill( row, row + _spikes.history.width(), 0u );
+		for( int_ i : spikes ) row[i / 32] |= 1u << ( i % 32 );
+	}
+}
+
+template <typename Model>
+void snn<Model>::save( std::string const & path ) const
+{
+	size_ const N = num_neurons();
+	size_ const E = _graph.adj.num_edges();
+
+	// (data, size in bytes), in the order restored by snn( checkpoint )
+	std::vector<std::pair<void const *, size_>> sections;
+	auto const add = [&]( auto const * data, size_ const n ) {
+		sections.push_back( { data, n * sizeof( *data ) } );
+	};
+
+	// Procedural graphs are stored like any other
+	std::vector<int> edges;
+	if( _graph.procedural )
+	{
+		edges.resize( E );
+		for( size_ i = 0; i < N; i++ )
+			_graph.procedural->for_each_neighbor(
+			    i, [&]( size_ j, int_ dst ) { edges[_graph.adj.offsets()[i] + j] = dst; } );
+	}
+
+	add( _graph.adj.offsets(), N + 1 );
+	add( _graph.procedural ? edges.data() : _graph.adj.edges(), E );
+	add( _delays.connections.data(), _delays.connections.size() );
+	add( _spikes.ids_data.data(), _spikes.ids_data.size() );
+	std::vector<size_> const counts( _spikes.counts.begin(), _spikes.counts.end() );
+	add( counts.data(), counts.size() );
+
+	std::vector<float> const dts( _spikes.dts.begin(), _spikes.dts.end() );
+	if constexpr( Model::synapse::size > 0 )
+	{
+		add( _spikes.history_data.data(), _spikes.history_data.size() );
+		add( dts.data(), dts.size() );
+		add( _graph.ages.data(), _graph.ages.size() );
+	}
+
+	auto neurons = _neurons.data();
+	spice::util::for_each( neurons, [&]( auto const * attr ) { add( attr, _last - _first ); } );
+	auto synapses = _synapses.data();
+	spice::util::for_each( synapses, [&]( auto const * attr ) { add( attr, E ); } );
+
+	checkpoint_header h{};
+	std::memcpy( h.magic, CHECKPOINT_MAGIC, 8 );
+	h.version = CHECKPOINT_VERSION;
+	h.neuron_attrs = Model::neuron::size;
+	h.neuron_bytes = Model::neuron::size_in_bytes;
+	h.synapse_attrs = Model::synapse::size;
+	h.synapse_bytes = Model::synapse::size_in_bytes;
+	h.delay = this->delay();
+	h.dt = this->dt();
+	h.num_steps = this->_num_steps();
+	h.simtime = this->_simulated_time();
+	h.simtime_residue = this->_simulated_time().residue();
+	h.seed = _backends.front().seed();
+	h.num_neurons = N;
+	h.first = _first;
+	h.last = _last;
+	h.num_edges = E;
+
+	spice_assert( sections.size() <= std::size( h.sections ) );
+	h.num_sections = sections.size();
+
+	auto const align = []( size_ const x ) {
+		return ( x + PAGE_SIZE - 1 ) / PAGE_SIZE * PAGE_SIZE;
+	};
+	size_ offset = align( sizeof( h ) );
+	for( size_ i = 0; i < sections.size(); i++ )
+	{
+		h.sections[i] = { offset, sections[i].second };
+		offset = align( offset + sections[i].second );
+	}
+
+	std::FILE * f = std::fopen( path.c_str(), "wb" );
+	if( !f ) throw std::runtime_error( "failed to open '" + path + "' for writing" );
+
+	static char const zeros[PAGE_SIZE] = {};
+	bool ok = std::fwrite( &h, sizeof( h ), 1, f ) == 1;
+	size_ pos = sizeof( h );
+	for( size_ i = 0; i < sections.size() && ok; i++ )
+	{
+		ok = std::fwrite( zeros, 1, h.sections[i].offset - pos, f ) == h.sections[i].offset - pos &&
+		     std::fwrite( sections[i].first, 1, sections[i].second, f ) == sections[i].second;
+		pos = h.sections[i].offset + sections[i].second;
+	}
+	ok = !std::fclose( f ) && ok;
+
+	if( !ok ) throw std::runtime_error( "failed to write '" + path + "'" );
+}
+
 
 // TODO: Remove code duplication
 template <typename Model>
@@ -196,22 +1188,56 @@ size_ snn<Model>::num_synapses() const
 template <typename Model>
 std::pair<std::vector<int>, size_> snn<Model>::adj() const
 {
-	return { _graph.edges, _graph.adj.max_degree() };
+	return _graph.procedural ? util::to_ell( *_graph.procedural ) : util::to_ell( _graph.adj );
 }
 template <typename Model>
 std::vector<typename Model::neuron::tuple_t> snn<Model>::neurons() const
 {
-	return _neurons.value_or( std::vector<typename Model::neuron::tuple_t>{} );
+	return _neurons.to_aos();
 }
 template <typename Model>
 std::vector<typename Model::synapse::tuple_t> snn<Model>::synapses() const
 {
-	return _synapses.value_or( std::vector<typename Model::synapse::tuple_t>{} );
-}
+	if constexpr( Model::synapse::size > 0 )
+	{
+		// Synapses are updated lazily, apply all pending updates to a copy.
+		auto copy = _synapses;
+		auto ages = _graph.ages;
+		auto bak = _backends.front();
+
+		auto const synapses = copy.data();
+		for( int_ i = 0; i < narrow<int>( num_neurons() ); i++ )
+			update_synapses<Model>(
+			    i,
+			    this->_num_steps(),
+			    ages[i],
+			    synapses,
+			    [this]( int_ const k, int_ const n ) { return spiked( k, n ); },
+			    _spikes.dts,
+			    _graph.adj,
+			    this->delay(),
+			    _info,
+			    bak );
 
+		// CSR -> ELL
+		auto const csr = copy.to_aos();
+		std::vector<typename Model::synapse::tuple_t> result( num_neurons() * ELL_WIDTH() );
+
+		for( size_ i = 0; i < num_neurons(); i++ )
+			std::copy(
+			    csr.begin() + _graph.adj.offsets()[i],
+			    csr.begin() + _graph.adj.offsets()[i + 1],
+			    result.begin() + i * ELL_WIDTH() );
+
+		return result;
+	}
+	else
+		return {};
+}
 
 template class snn<vogels_abbott>;
 template class snn<brunel>;
+template class snn<brunel_with_inputs>;
 template class snn<brunel_with_plasticity>;
 template class snn<synth>;
 } // namespace spice::cpu
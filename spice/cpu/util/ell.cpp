@@ -0,0 +1,32 @@
+#include "ell.h"
+
+#include <algorithm>
+
+
+namespace spice::cpu::util
+{
+std::pair<std::vector<int>, size_> to_ell( spice::util::adj_list const & adj )
+{
+	size_ const W = ell_width( adj.max_degree() );
+	std::vector<int> result( adj.num_nodes() * W, -1 );
+
+	for( size_ i = 0; i < adj.num_nodes(); i++ )
+	{
+		auto const row = adj.neighbors( i );
+		std::copy( row.begin(), row.end(), result.begin() + i * W );
+	}
+
+	return { result, W };
+}
+
+std::pair<std::vector<int>, size_> to_ell( spice::util::procedural_adj_list const & adj )
+{
+	size_ const W = ell_width( adj.max_degree() );
+	std::vector<int> result( adj.num_nodes() * W, -1 );
+
+	for( size_ i = 0; i < adj.num_nodes(); i++ )
+		adj.for_each_neighbor( i, [&]( size_ j, int_ dst ) { result[i * W + j] = dst; } );
+
+	return { result, W };
+}
+} // namespace spice::cpu::util
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <spice/util/adj_list.h>
+#include <spice/util/procedural_adj_list.h>
+#include <spice/util/stdint.h>
+
+#include <utility>
+#include <vector>
+
+
+namespace spice
+{
+namespace cpu
+{
+namespace util
+{
+// Rows of the ELL adjacency lists returned by adj() are padded to multiples of ELL_ALIGN, the
+// width the GPU backends pad to (one warp), so that all backends report identical layouts.
+constexpr size_ ELL_ALIGN = 32;
+
+// @return the width of an ELL adjacency list whose longest row has 'max_degree' entries
+constexpr size_ ell_width( size_ const max_degree )
+{
+	return ( max_degree + ELL_ALIGN - 1 ) / ELL_ALIGN * ELL_ALIGN;
+}
+
+// @return (edges, width) of 'adj' as an ELL adjacency list of width ell_width( max. degree ),
+// padded with -1, as returned by the backends' adj()
+std::pair<std::vector<int>, size_> to_ell( spice::util::adj_list const & adj );
+std::pair<std::vector<int>, size_> to_ell( spice::util::procedural_adj_list const & adj );
+} // namespace util
+} // namespace cpu
+} // namespace spice
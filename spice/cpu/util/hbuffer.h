@@ -0,0 +1,135 @@
+#pragma once
+
+#include <spice/util/assert.h>
+#include <spice/util/stdint.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace spice
+{
+namespace cpu
+{
+namespace util
+{
+// Zero-initialized, cache line-aligned, type-safe storage on the host.
+// Host counterpart of cuda::util::dbuffer, usable with util::soa_t.
+template <typename T>
+class hbuffer
+{
+public:
+	static_assert( std::is_trivially_copyable_v<T>, "copy does not invoke ctors" );
+
+	static constexpr size_ alignment = 64;
+
+	hbuffer() = default;
+	explicit hbuffer( size_ size ) { resize( size ); }
+	hbuffer( hbuffer const & copy ) { copy_from( copy ); }
+	hbuffer( std::vector<T> const & copy ) { copy_from( copy ); }
+	hbuffer( hbuffer && tmp ) noexcept { swap( tmp ); }
+	// Adopts 'size' elements at 'data' (cache line-aligned) without copying them. 'owner' keeps
+	// them alive (e.g. a memory-mapped file) for as long as the buffer uses them.
+	hbuffer( T * data, size_ size, std::shared_ptr<void> owner )
+	    : _data( data, deleter{ std::move( owner ) } )
+	    , _size( size )
+	    , _capacity( size )
+	{
+		spice_assert( reinterpret_cast<std::uintptr_t>( data ) % alignment == 0, "misaligned" );
+	}
+
+	hbuffer & operator=( hbuffer const & rhs )
+	{
+		copy_from( rhs );
+		return *this;
+	}
+	hbuffer & operator=( std::vector<T> const & rhs )
+	{
+		copy_from( rhs );
+		return *this;
+	}
+	hbuffer & operator=( hbuffer && tmp ) noexcept
+	{
+		hbuffer( std::move( tmp ) ).swap( *this );
+		return *this;
+	}
+
+	operator std::vector<T>() const { return { begin(), end() }; }
+
+	T * data() { return _data.get(); }
+	T const * data() const { return _data.get(); }
+	size_ size() const { return _size; }
+	size_ size_in_bytes() const { return size() * sizeof( T ); }
+
+	T & operator[]( size_ i ) { return data()[i]; }
+	T const & operator[]( size_ i ) const { return data()[i]; }
+
+	T * begin() { return data(); }
+	T const * begin() const { return data(); }
+	T * end() { return data() + size(); }
+	T const * end() const { return data() + size(); }
+
+	// Preserves the first min(n, size()) elements, zeroes the rest.
+	void resize( size_ n )
+	{
+		if( n > _capacity )
+		{
+			std::unique_ptr<T, deleter> tmp( static_cast<T *>(
+			    ::operator new( n * sizeof( T ), std::align_val_t{ alignment } ) ) );
+
+			if( size() ) std::memcpy( tmp.get(), data(), size_in_bytes() );
+			_data = std::move( tmp );
+			_capacity = n;
+		}
+
+		if( n > size() ) std::memset( data() + size(), 0, ( n - size() ) * sizeof( T ) );
+		_size = n;
+	}
+
+	void zero()
+	{
+		if( size() ) std::memset( data(), 0, size_in_bytes() );
+	}
+
+	void swap( hbuffer & other ) noexcept
+	{
+		std::swap( _data, other._data );
+		std::swap( _size, other._size );
+		std::swap( _capacity, other._capacity );
+	}
+
+private:
+	struct deleter
+	{
+		// (adopted memory only)
+		std::shared_ptr<void> owner;
+
+		void operator()( T * p ) const
+		{
+			if( !owner ) ::operator delete( p, std::align_val_t{ alignment } );
+		}
+	};
+
+	std::unique_ptr<T, deleter> _data;
+	size_ _size = 0;
+	size_ _capacity = 0;
+
+	template <typename Cont>
+	void copy_from( Cont const & cont )
+	{
+		if( data() == cont.data() && size() == cont.size() ) return;
+
+		_size = 0;
+		resize( cont.size() );
+		if( size() ) std::memcpy( data(), cont.data(), size_in_bytes() );
+	}
+};
+} // namespace util
+} // namespace cpu
+} // namespace spice
@@ -0,0 +1,132 @@
+#include "numa.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+
+// Parses a list of ranges such as "0-3,8,10-11"
+static std::vector<int> parse_list( std::string const & list )
+{
+	std::vector<int> result;
+
+	std::istringstream s( list );
+	std::string range;
+	while( std::getline( s, range, ',' ) )
+	{
+		if( range.empty() || range == "\n" ) continue;
+
+		auto const dash = range.find( '-' );
+		int const first = std::stoi( range.substr( 0, dash ) );
+		int const last = dash == std::string::npos ? first : std::stoi( range.substr( dash + 1 ) );
+		for( int i = first; i <= last; i++ ) result.push_back( i );
+	}
+
+	return result;
+}
+
+static std::string read_line( std::string const & path )
+{
+	std::ifstream f( path );
+	std::string line;
+	std::getline( f, line );
+	return line;
+}
+
+static std::string const sysfs = "/sys/devices/system/node/";
+
+
+namespace spice::cpu::util
+{
+std::vector<int> numa_nodes()
+{
+	auto result = parse_list( read_line( sysfs + "has_cpu" ) );
+	if( result.empty() ) result = parse_list( read_line( sysfs + "online" ) );
+	if( result.empty() ) result.push_back( 0 );
+
+	return result;
+}
+
+std::vector<int> numa_cpus( int const node )
+{
+	return parse_list( read_line( sysfs + "node" + std::to_string( node ) + "/cpulist" ) );
+}
+
+
+std::vector<int> thread_affinity()
+{
+	std::vector<int> result;
+#ifdef __linux__
+	for( int n = CPU_SETSIZE;; n *= 2 )
+	{
+		cpu_set_t * set = CPU_ALLOC( n );
+		size_t const size = CPU_ALLOC_SIZE( n );
+		CPU_ZERO_S( size, set );
+
+		bool const ok = !sched_getaffinity( 0, size, set );
+		if( ok )
+			for( int i = 0; i < n; i++ )
+				if( CPU_ISSET_S( i, size, set ) ) result.push_back( i );
+
+		CPU_FREE( set );
+		if( ok || errno != EINVAL || n >= ( 1 << 20 ) ) break;
+	}
+#endif
+	return result;
+}
+
+bool set_thread_affinity( std::vector<int> const & cpus )
+{
+#ifdef __linux__
+	if( cpus.empty() ) return false;
+
+	int const n = *std::max_element( cpus.begin(), cpus.end() ) + 1;
+	cpu_set_t * set = CPU_ALLOC( n );
+	size_t const size = CPU_ALLOC_SIZE( n );
+	CPU_ZERO_S( size, set );
+	for( int i : cpus ) CPU_SET_S( i, size, set );
+
+	bool const ok = !sched_setaffinity( 0, size, set );
+	CPU_FREE( set );
+	return ok;
+#else
+	(void)cpus;
+	return false;
+#endif
+}
+
+
+// static
+numa_alloc_stats numa_alloc_stats::read()
+{
+	numa_alloc_stats result;
+	for( int node : numa_nodes() )
+	{
+		std::ifstream f( sysfs + "node" + std::to_string( node ) + "/numastat" );
+		std::string key;
+		ulong_ value;
+		while( f >> key >> value )
+		{
+			if( key == "local_node" ) result.local += value;
+			if( key == "other_node" ) result.other += value;
+		}
+	}
+	return result;
+}
+
+double numa_alloc_stats::other_ratio() const
+{
+	return local + other ? static_cast<double>( other ) / ( local + other ) : 0.0;
+}
+
+numa_alloc_stats numa_alloc_stats::operator-( numa_alloc_stats const & rhs ) const
+{
+	return { local - rhs.local, other - rhs.other };
+}
+} // namespace spice::cpu::util
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <spice/util/stdint.h>
+
+#include <vector>
+
+
+namespace spice
+{
+namespace cpu
+{
+namespace util
+{
+// Thin wrappers around Linux' NUMA topology (/sys/devices/system/node) and thread affinity.
+// On other platforms (or if /sys is not available) the system appears as a single node without
+// any known CPUs and pinning is a no-op.
+
+// @return ids of all NUMA nodes with CPUs attached, in ascending order. Never empty.
+std::vector<int> numa_nodes();
+// @return ids of the CPUs attached to 'node'
+std::vector<int> numa_cpus( int node );
+
+// @return ids of the CPUs the calling thread may run on
+std::vector<int> thread_affinity();
+// Restricts the calling thread to 'cpus'. Threads spawned by it afterwards inherit the affinity,
+// and pages it touches first are allocated on (one of) the nodes of 'cpus'.
+// @return false if unsupported or 'cpus' is empty (the affinity remains unchanged)
+bool set_thread_affinity( std::vector<int> const & cpus );
+
+// Node allocation counters (system-wide), summed over all nodes (see numastat): 'local' counts
+// pages allocated on the node of the thread requesting them, 'other' the ones that had to be
+// allocated on another node. They count the allocations of every process on the system and say
+// nothing about where pages are accessed from later. The difference of two snapshots taken
+// around a run (of an otherwise idle system) approximates that run's page placement only.
+struct numa_alloc_stats
+{
+	ulong_ local = 0;
+	ulong_ other = 0;
+
+	static numa_alloc_stats read();
+
+	// other / (local + other), 0 if there were no allocations at all
+	double other_ratio() const;
+
+	numa_alloc_stats operator-( numa_alloc_stats const & rhs ) const;
+};
+} // namespace util
+} // namespace cpu
+} // namespace spice
@@ -0,0 +1,104 @@
+#include "thread_pool.h"
+
+#include <spice/util/assert.h>
+
+#include <algorithm>
+
+
+namespace spice::cpu::util
+{
+thread_pool::thread_pool( int_ const num_threads /* = 1 */ )
+{
+	spice_assert( num_threads >= 1, "thread pool requires at least 1 thread" );
+
+	_workers.reserve( num_threads - 1 );
+	for( int_ i = 1; i < num_threads; i++ ) _workers.emplace_back( [this, i] { _work( i ); } );
+}
+
+thread_pool::~thread_pool()
+{
+	{
+		std::lock_guard _( _lock );
+		_running = false;
+	}
+	_start.notify_all();
+
+	for( auto & w : _workers ) w.join();
+}
+
+
+int_ thread_pool::size() const { return static_cast<int_>( _workers.size() ) + 1; }
+
+void thread_pool::_run( void ( *fn )( void *, int_ ), void * job )
+{
+	{
+		std::lock_guard _( _lock );
+		_fn = fn;
+		_job = job;
+		_pending = size() - 1;
+		_error = nullptr;
+		_generation++;
+	}
+	_start.notify_all();
+
+	_invoke( 0 );
+
+	std::unique_lock l( _lock );
+	_done.wait( l, [this] { return _pending == 0; } );
+	_fn = nullptr;
+	_job = nullptr;
+
+	if( _error ) std::rethrow_exception( std::exchange( _error, nullptr ) );
+}
+
+// static
+std::pair<size_, size_>
+thread_pool::chunk( size_ const size, int_ const n, int_ const i, size_ const align /* = 1 */ )
+{
+	spice_assert( n > 0 );
+	spice_assert( i >= 0 && i < n );
+	spice_assert( align > 0 );
+
+	size_ const blocks = ( size + align - 1 ) / align;
+
+	return { std::min( size, blocks * i / n * align ),
+	         std::min( size, blocks * ( i + 1 ) / n * align ) };
+}
+
+
+void thread_pool::_work( int_ const ithread )
+{
+	ulong_ generation = 0;
+	while( true )
+	{
+		{
+			std::unique_lock l( _lock );
+			_start.wait( l, [&] { return !_running || _generation != generation; } );
+
+			if( !_running ) return;
+			generation = _generation;
+		}
+
+		_invoke( ithread );
+
+		{
+			std::lock_guard _( _lock );
+			--_pending;
+		}
+		_done.notify_one();
+	}
+}
+
+void thread_pool::_invoke( int_ const ithread )
+{
+	try
+	{
+		_fn( _job, ithread );
+	}
+	catch( ... )
+	{
+		std::lock_guard _( _lock );
+		if( !_error ) _error = std::current_exception();
+	}
+}
+} // namespace spice::cpu::util
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <spice/util/stdint.h>
+
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace spice
+{
+namespace cpu
+{
+namespace util
+{
+// Fixed-size pool of persistent worker threads. The calling thread always participates as
+// thread 0, so a pool of size 1 spawns no threads at all and runs everything inline.
+class thread_pool
+{
+public:
+	explicit thread_pool( int_ num_threads = 1 );
+
+	thread_pool( thread_pool const & ) = delete;
+	thread_pool & operator=( thread_pool const & ) = delete;
+	thread_pool( thread_pool && ) = delete;
+	thread_pool & operator=( thread_pool && ) = delete;
+
+	~thread_pool();
+
+	int_ size() const;
+
+	// Invokes 'f( ithread )' for every ithread in [0, size()) concurrently and blocks until all
+	// invocations have returned. Rethrows the first exception thrown by any of them.
+	// A pool of size 1 calls 'f' directly, larger ones pass it to the workers type-erased.
+	template <typename F>
+	void run( F && f )
+	{
+		if( _workers.empty() )
+		{
+			f( 0 );
+			return;
+		}
+
+		using fn_t = std::remove_reference_t<F>;
+		_run(
+		    []( void * const job, int_ const ithread ) {
+			    ( *static_cast<fn_t *>( job ) )( ithread );
+		    },
+		    const_cast<void *>( static_cast<void const *>( std::addressof( f ) ) ) );
+	}
+
+	// Splits [0, n) into size() contiguous chunks and invokes 'f( first, last, ithread )' for each.
+	// Chunk boundaries are multiples of 'align' (except for the last one), which allows workers
+	// to write to bit- or cache line-granular data without false sharing.
+	template <typename F>
+	void parallel_for( size_ n, F && f, size_ align = 1 )
+	{
+		if( _workers.empty() )
+		{
+			if( n > 0 ) f( 0_sz, n, 0 );
+			return;
+		}
+
+		run( [&]( int_ const ithread ) {
+			auto const [first, last] = chunk( n, size(), ithread, align );
+			if( first < last ) f( first, last, ithread );
+		} );
+	}
+
+	// @return [first, last) of the i-th out of n roughly equally-sized chunks of [0, size)
+	static std::pair<size_, size_> chunk( size_ size, int_ n, int_ i, size_ align = 1 );
+
+private:
+	std::vector<std::thread> _workers;
+
+	std::mutex _lock;
+	std::condition_variable _start;
+	std::condition_variable _done;
+
+	// current job: _fn( _job, ithread ) invokes it
+	void ( *_fn )( void *, int_ ) = nullptr;
+	void * _job = nullptr;
+	ulong_ _generation = 0;
+	int_ _pending = 0;
+	bool _running = true;
+	std::exception_ptr _error;
+
+	void _run( void ( *fn )( void *, int_ ), void * job );
+	void _work( int_ ithread );
+	void _invoke( int_ ithread );
+};
+} // namespace util
+} // namespace cpu
+} // namespace spice
@@ -166,10 +166,11 @@ static __global__ void _process_neurons(
     int_ const slice_width,
     int_ const n,
     int_ const igpu,
-    snn_info const info,
+    info_t<Model> const info,
     ulong_ const seed,
 
     float const dt = 0,
+    propagator_t<typename Model::neuron> const prop = {},
     int_ * spikes = nullptr,
     uint_ * num_spikes = nullptr,
 
@@ -197,7 +198,12 @@ static __global__ void _process_neurons(
 			Model::neuron::template init( it, info, bak );
 		else // udpate
 		{
-			bool const spiked = Model::neuron::template update( it, dt, info, bak );
+			bool spiked = false;
+			with_population<typename Model::neuron>( i, info, [&]( auto const P ) {
+				spiked = update_neuron<typename Model::neuron, decltype( P )::value>(
+				    it, dt, info, bak );
+			} );
+			prop.apply( it );
 
 			if constexpr( Model::synapse::size > 0 ) // plast.
 			{
@@ -222,7 +228,7 @@ enum mode
 };
 template <typename Model, mode MODE>
 static __global__ void _process_spikes(
-    snn_info const info,
+    info_t<Model> const info,
     ulong_ const seed,
     span2d<int_ const> adj,
 
@@ -267,12 +273,14 @@ static __global__ void _process_spikes(
 						    bak );
 
 				if constexpr( MODE == HNDL_SPKS )
-					Model::neuron::template receive(
-					    src,
-					    neuron_iter<typename Model::neuron>( dst ),
-					    const_synapse_iter<typename Model::synapse>( isyn ),
-					    info,
-					    bak );
+					with_population<typename Model::neuron>( src, info, [&]( auto const P ) {
+						receive_spike<typename Model::neuron, decltype( P )::value>(
+						    src,
+						    neuron_iter<typename Model::neuron>( dst ),
+						    const_synapse_iter<typename Model::synapse>( isyn ),
+						    info,
+						    bak );
+					} );
 			}
 		}
 
@@ -286,7 +294,7 @@ static __global__ void _process_spikes(
 
 template <typename Model>
 static __global__ void _process_spikes_cache_aware(
-    snn_info const info,
+    info_t<Model> const info,
     ulong_ const seed,
     span2d<int_ const> adj,
 
@@ -306,12 +314,14 @@ static __global__ void _process_spikes_cache_aware(
 		int_ const dst = adj( src, WARP_SZ * o + threadIdx.x );
 
 		if( dst >= 0 )
-			Model::neuron::template receive(
-			    src,
-			    neuron_iter<typename Model::neuron>( dst ),
-			    const_synapse_iter<typename Model::synapse>( 0 ),
-			    info,
-			    bak );
+			with_population<typename Model::neuron>( src, info, [&]( auto const P ) {
+				receive_spike<typename Model::neuron, decltype( P )::value>(
+				    src,
+				    neuron_iter<typename Model::neuron>( dst ),
+				    const_synapse_iter<typename Model::synapse>( 0 ),
+				    info,
+				    bak );
+			} );
 	}
 }
 
@@ -434,7 +444,7 @@ void init(
     int_ n,
     int_ i,
 
-    snn_info const info,
+    info_t<Model> const & info,
     span2d<int_ const> adj /* = {} */ )
 {
 	spice_assert( slice_width > 0 );
@@ -449,12 +459,19 @@ void init(
 	if constexpr( Model::synapse::size > 0 )
 		call( [&] { _process_spikes<Model, INIT_SYNS><<<256, 256, 0, s>>>( info, seed(), adj ); } );
 }
-template void
-    init<::spice::vogels_abbott>( cudaStream_t, int_, int_, int_, snn_info, span2d<int_ const> );
-template void init<::spice::brunel>( cudaStream_t, int_, int_, int_, snn_info, span2d<int_ const> );
+template void init<::spice::vogels_abbott>(
+    cudaStream_t, int_, int_, int_, info_t<::spice::vogels_abbott> const &, span2d<int_ const> );
+template void init<::spice::brunel>(
+    cudaStream_t, int_, int_, int_, info_t<::spice::brunel> const &, span2d<int_ const> );
 template void init<::spice::brunel_with_plasticity>(
-    cudaStream_t, int_, int_, int_, snn_info, span2d<int_ const> );
-template void init<::spice::synth>( cudaStream_t, int_, int_, int_, snn_info, span2d<int_ const> );
+    cudaStream_t,
+    int_,
+    int_,
+    int_,
+    info_t<::spice::brunel_with_plasticity> const &,
+    span2d<int_ const> );
+template void init<::spice::synth>(
+    cudaStream_t, int_, int_, int_, info_t<::spice::synth> const &, span2d<int_ const> );
 
 template <typename Model>
 void update(
@@ -463,8 +480,9 @@ void update(
     int_ slice_width,
     int_ n,
     int_ i,
-    snn_info const info,
+    info_t<Model> const & info,
     float const dt,
+    propagator_t<typename Model::neuron> const & prop,
     int_ * spikes,
     uint_ * num_spikes,
 
@@ -489,6 +507,7 @@ void update(
 		    info,
 		    seed(),
 		    dt,
+		    prop,
 		    spikes,
 		    num_spikes,
 		    history.row( circidx( iter, max_history ) ),
@@ -505,8 +524,9 @@ template void update<::spice::vogels_abbott>(
     int_,
     int_,
     int_,
-    snn_info,
+    info_t<::spice::vogels_abbott> const &,
     float,
+    propagator_t<::spice::vogels_abbott::neuron> const &,
     int_ *,
     uint_ *,
     span2d<uint_>,
@@ -521,8 +541,9 @@ template void update<::spice::brunel>(
     int_,
     int_,
     int_,
-    snn_info,
+    info_t<::spice::brunel> const &,
     float,
+    propagator_t<::spice::brunel::neuron> const &,
     int_ *,
     uint_ *,
     span2d<uint_>,
@@ -537,8 +558,9 @@ template void update<::spice::brunel_with_plasticity>(
     int_,
     int_,
     int_,
-    snn_info,
+    info_t<::spice::brunel_with_plasticity> const &,
     float,
+    propagator_t<::spice::brunel_with_plasticity::neuron> const &,
     int_ *,
     uint_ *,
     span2d<uint_>,
@@ -553,8 +575,9 @@ template void update<::spice::synth>(
     int_,
     int_,
     int_,
-    snn_info,
+    info_t<::spice::synth> const &,
     float,
+    propagator_t<::spice::synth::neuron> const &,
     int_ *,
     uint_ *,
     span2d<uint_>,
@@ -569,7 +592,7 @@ template <typename Model>
 void receive(
     cudaStream_t s,
 
-    snn_info const info,
+    info_t<Model> const & info,
     span2d<int_ const> adj,
 
     int_ const * spikes,
@@ -634,7 +657,7 @@ void receive(
 }
 template void receive<::spice::vogels_abbott>(
     cudaStream_t,
-    snn_info const,
+    info_t<::spice::vogels_abbott> const &,
     span2d<int_ const>,
     int_ const *,
     uint_ const *,
@@ -648,7 +671,7 @@ template void receive<::spice::vogels_abbott>(
     float const dt );
 template void receive<::spice::brunel>(
     cudaStream_t,
-    snn_info const,
+    info_t<::spice::brunel> const &,
     span2d<int_ const>,
     int_ const *,
     uint_ const *,
@@ -662,7 +685,7 @@ template void receive<::spice::brunel>(
     float const dt );
 template void receive<::spice::brunel_with_plasticity>(
     cudaStream_t,
-    snn_info const,
+    info_t<::spice::brunel_with_plasticity> const &,
     span2d<int_ const>,
     int_ const *,
     uint_ const *,
@@ -676,7 +699,7 @@ template void receive<::spice::brunel_with_plasticity>(
     float const dt );
 template void receive<::spice::synth>(
     cudaStream_t,
-    snn_info const,
+    info_t<::spice::synth> const &,
     span2d<int_ const>,
     int_ const *,
     uint_ const *,
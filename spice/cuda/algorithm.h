@@ -1,8 +1,9 @@
 #pragma once
 
-#include <spice/snn_info.h>
+#include <spice/models/model.h>
 #include <spice/util/adj_list.h>
 #include <spice/util/layout.h>
+#include <spice/util/propagator.h>
 #include <spice/util/span2d.h>
 
 #include <cuda_runtime.h>
@@ -26,7 +27,7 @@ void init(
     int_ slice_width,
     int_ n,
     int_ i,
-    snn_info info,
+    info_t<Model> const & info,
     spice::util::span2d<int_ const> adj = {} );
 
 template <typename Model>
@@ -36,8 +37,9 @@ void update(
     int_ slice_width,
     int_ n,
     int_ i,
-    snn_info info,
+    info_t<Model> const & info,
     float dt,
+    spice::util::propagator_t<typename Model::neuron> const & prop,
     int_ * spikes,
     uint_ * out_num_spikes,
 
@@ -53,7 +55,7 @@ template <typename Model>
 void receive(
     cudaStream_t s,
 
-    snn_info info,
+    info_t<Model> const & info,
     spice::util::span2d<int_ const> adj,
 
     int_ const * spikes,
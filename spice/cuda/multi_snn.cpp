@@ -298,7 +298,10 @@ size_ multi_snn<Model>::num_neurons() const
 template <typename Model>
 size_ multi_snn<Model>::num_synapses() const
 {
-	return adj().first.size();
+	// every device holds a disjoint subset of the edges
+	size_ result = 0;
+	for( size_ i = 0; i < device::devices().size(); i++ ) result += _nets[i]->num_synapses();
+	return result;
 }
 
 template <typename Model>
@@ -12,6 +12,7 @@
 #include <spice/util/assert.h>
 #include <spice/util/type_traits.h>
 
+#include <algorithm>
 #include <ctime>
 
 
@@ -27,6 +28,12 @@ int_ snn<Model>::MAX_HISTORY() const
 	return std::max( this->delay() + 1, 32 );
 }
 
+// @return the no. of actual edges in the ELL adjacency list 'edges' (padded with -1)
+static size_ count_edges( std::vector<int> const & edges )
+{
+	return std::count_if( edges.begin(), edges.end(), []( int const e ) { return e >= 0; } );
+}
+
 #pragma warning( push )
 #pragma warning( disable : 4100 ) // unreferenced formal parameter 'num_synapses' for certain
                                   // template inst.
@@ -62,6 +69,13 @@ void snn<Model>::reserve( size_ const num_neurons, size_ const num_synapses, int
 }
 #pragma warning( pop )
 
+template <typename Model>
+void snn<Model>::init_constants()
+{
+	_info = make_info<Model>( this->info() );
+	_propagator = { Model::neuron::dynamics( _info ), this->dt() };
+}
+
 
 template <typename Model>
 snn<Model>::snn(
@@ -78,9 +92,15 @@ snn<Model>::snn(
 {
 	spice_assert( dt > 0.0f );
 	spice_assert( delay >= 1 );
+	spice_assert(
+	    desc.min_delay( delay ) == delay && desc.max_delay( delay ) == delay,
+	    "per-connection delays are not supported by this backend" );
 
 	reserve( desc.size(), desc.size() * desc.max_degree(), delay );
 	generate_rnd_adj_list( _sim, desc, _graph.edges.data() );
+	_sim.synchronize();
+	_num_synapses = count_edges( _graph.edges );
+	init_constants();
 
 	upload_meta<Model>( _sim, _neurons.data(), _synapses.data() );
 	spice::cuda::init<Model>(
@@ -88,7 +108,7 @@ snn<Model>::snn(
 	    _slice_width,
 	    _n,
 	    _i,
-	    this->info(),
+	    _info,
 	    { _graph.edges.data(), narrow<int>( _graph.adj.max_degree() ) } );
 }
 
@@ -114,6 +134,8 @@ snn<Model>::snn(
 
 	reserve( adj.size() / width, adj.size(), delay );
 	_graph.edges = adj;
+	_num_synapses = count_edges( adj );
+	init_constants();
 
 	upload_meta<Model>( _sim, _neurons.data(), _synapses.data() );
 	spice::cuda::init<Model>(
@@ -121,7 +143,7 @@ snn<Model>::snn(
 	    _slice_width,
 	    _n,
 	    _i,
-	    this->info(),
+	    _info,
 	    { _graph.edges.data(), narrow<int>( _graph.adj.max_degree() ) } );
 }
 
@@ -132,9 +154,12 @@ snn<Model>::snn( spice::snn<Model> const & net )
     , _n( 1 )
     , _i( 0 )
 {
-	reserve( net.num_neurons(), net.num_synapses(), net.delay() );
+	auto const edges = net.adj().first;
+	reserve( net.num_neurons(), edges.size(), net.delay() );
+	_graph.edges = edges;
+	_num_synapses = net.num_synapses();
+	init_constants();
 
-	_graph.edges = net.adj().first;
 	_neurons.from_aos( net.neurons() );
 	_synapses.from_aos( net.synapses() );
 
@@ -160,7 +185,7 @@ void snn<Model>::step(
 			receive<Model>(
 			    _sim,
 
-			    this->info(),
+			    _info,
 			    { _graph.edges.data(), narrow<int>( _graph.adj.max_degree() ) },
 
 			    _spikes.ids.row( circidx( i, this->delay() ) ),
@@ -184,8 +209,9 @@ void snn<Model>::step(
 		    _slice_width,
 		    _n,
 		    _i,
-		    this->info(),
-		    dt,
+		    _info,
+		    update_dt<typename Model::neuron>( dt, this->dt() ),
+		    _propagator,
 		    _spikes.ids.row( circidx( i, this->delay() ) ),
 		    _spikes.counts.data() + circidx( i, this->delay() ),
 
@@ -226,7 +252,7 @@ size_ snn<Model>::num_neurons() const
 template <typename Model>
 size_ snn<Model>::num_synapses() const
 {
-	return _graph.adj.num_edges();
+	return _num_synapses;
 }
 template <typename Model>
 std::pair<std::vector<int>, size_> snn<Model>::adj() const
@@ -4,9 +4,11 @@
 #include <spice/cuda/util/dbuffer.h>
 #include <spice/cuda/util/dvar.h>
 #include <spice/cuda/util/stream.h>
+#include <spice/models/model.h>
 #include <spice/snn.h>
 #include <spice/util/circular_buffer.h>
 #include <spice/util/meta.h>
+#include <spice/util/propagator.h>
 #include <spice/util/span.hpp>
 #include <spice/util/span2d.h>
 
@@ -17,6 +19,8 @@ template <typename Model>
 class snn : public ::spice::snn<Model>
 {
 public:
+	static_assert( Model::neuron::input::size == 0, "neuron inputs are only supported on the CPU" );
+
 	snn( spice::util::layout const & desc,
 	     float dt,
 	     int_ delay = 1,
@@ -46,6 +50,10 @@ public:
 private:
 	spice::util::soa_t<util::dbuffer, typename Model::neuron> _neurons;
 	spice::util::soa_t<util::dbuffer, typename Model::synapse> _synapses;
+	// info() along with the model's constants, and the propagator of its neurons' linear
+	// dynamics (see spice::neuron), both computed once per network
+	spice::info_t<Model> _info;
+	spice::util::propagator_t<typename Model::neuron> _propagator;
 
 	struct
 	{
@@ -53,6 +61,8 @@ private:
 		spice::util::adj_list adj;
 		util::dbuffer<int> ages;
 	} _graph;
+	// no. of actual edges, excl. the padding of _graph.edges
+	size_ _num_synapses = 0;
 
 	struct
 	{
@@ -77,5 +87,7 @@ private:
 	int_ MAX_HISTORY() const;
 
 	void reserve( size_ num_neurons, size_ max_degree, int_ delay );
+	// Computes _info and _propagator, requires the graph (and _num_synapses) to be initialized
+	void init_constants();
 };
 } // namespace spice::cuda
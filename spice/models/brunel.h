@@ -8,6 +8,16 @@ namespace spice
 {
 struct brunel : model
 {
+	struct constants_t
+	{
+		float Wex; // v
+		float Win; // v
+	};
+	static constants_t constants( snn_info const info )
+	{
+		return { 0.0001f * 20'000 / info.num_neurons, -0.0005f * 20'000 / info.num_neurons };
+	}
+
 	struct neuron : ::spice::neuron<float, int_>
 	{             //                  |     |
 		enum attr //                  |     |
@@ -16,6 +26,25 @@ struct brunel : model
 			Twait //________________________|
 		};
 
+		// [0, N/2) Poisson neurons, [N/2, 0.9N) excitatory, [0.9N, N) inhibitory LIF neurons
+		enum pop
+		{
+			Poisson,
+			Exc,
+			Inh
+		};
+		static constexpr int_ num_populations = 3;
+		static int_ population( int_ const p, snn_info const info )
+		{
+			switch( p )
+			{
+				case Poisson: return 0;
+				case Exc: return info.num_neurons / 2;
+				case Inh: return static_cast<int>( 0.9f * info.num_neurons );
+				default: return info.num_neurons;
+			}
+		}
+
 		template <typename Iter, typename Backend>
 		HYBRID static void init( Iter n, snn_info, Backend & )
 		{
@@ -27,17 +56,25 @@ struct brunel : model
 			get<Twait>( n ) = 0;
 		}
 
-		template <typename Iter, typename Backend>
-		HYBRID static bool update( Iter n, float const dt, snn_info info, Backend & bak )
+		// dV/dt = ( Vrest - V ) / Tmem
+		static util::linear_dynamics<V> dynamics( snn_info )
+		{
+			double const TmemInv = 1.0 / 0.02; // s
+			double const Vrest = 0.0;          // v
+
+			return { { { -TmemInv } }, { Vrest * TmemInv } };
+		}
+
+		template <int_ P, typename Iter, typename Backend>
+		HYBRID static bool update( Iter n, float const dt, snn_info, Backend & bak )
 		{
 			using util::get;
 
-			float const TmemInv = 1.0 / 0.02; // s
-			float const Vrest = 0.0;          // v
-			int_ const Tref = 20;              // dt
-			float const Vthres = 0.02f;       // v
+			float const Vrest = 0.0;    // v
+			int_ const Tref = 20;       // dt
+			float const Vthres = 0.02f; // v
 
-			if( n.id() < static_cast<uint_>( info.num_neurons / 2 ) ) // poisson neuron
+			if constexpr( P == Poisson )
 			{
 				float const firing_rate = 20; // Hz
 
@@ -45,38 +82,26 @@ struct brunel : model
 			}
 			else
 			{
-				if( --get<Twait>( n ) <= 0 )
+				if( --get<Twait>( n ) <= 0 && get<V>( n ) > Vthres )
 				{
-					if( get<V>( n ) > Vthres )
-					{
-						get<V>( n ) = Vrest;
-						get<Twait>( n ) = Tref;
-						return true;
-					}
-
-					get<V>( n ) += ( Vrest - get<V>( n ) ) * ( dt * TmemInv );
+					get<V>( n ) = Vrest;
+					get<Twait>( n ) = Tref;
+					return true;
 				}
 			}
 
 			return false;
 		}
 
-		template <typename Iter, typename SynIter, typename Backend>
-		HYBRID static void receive( int_ src, Iter dst, SynIter, snn_info info, Backend & bak )
+		template <int_ P, typename Iter, typename SynIter, typename Backend>
+		HYBRID static void receive(
+		    int_, Iter dst, SynIter, model_info<constants_t> const & info, Backend & bak )
 		{
 			using util::get;
 
 			if( get<Twait>( dst ) <= 0 )
-			{
-				auto const nexc = static_cast<int>( 0.9f * info.num_neurons );
-				float const Wex = 0.0001f * 20'000 / info.num_neurons;  // v
-				float const Win = -0.0005f * 20'000 / info.num_neurons; // v
-
-				if( src < nexc ) // excitatory src neuron
-					bak.atomic_add( get<V>( dst ), Wex );
-				else // inhibotory src neuron
-					bak.atomic_add( get<V>( dst ), Win );
-			}
+				bak.atomic_add(
+				    get<V>( dst ), P == Inh ? info.constants.Win : info.constants.Wex );
 		}
 	};
 };
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <spice/models/model.h>
+#include <spice/snn_info.h>
+
+
+namespace spice
+{
+// brunel, receiving into an input accumulator instead of its membrane potential: receive only
+// streams weights into memory, update applies their sum. Since weights are summed before being
+// added to V, results differ from brunel's in rounding. CPU only.
+struct brunel_with_inputs : model
+{
+	struct constants_t
+	{
+		float Wex; // v
+		float Win; // v
+	};
+	static constants_t constants( snn_info const info )
+	{
+		return { 0.0001f * 20'000 / info.num_neurons, -0.0005f * 20'000 / info.num_neurons };
+	}
+
+	struct neuron : ::spice::neuron<float, int_>
+	{             //                  |     |
+		enum attr //                  |     |
+		{         //                  |     |
+			V,    //__________________|     |
+			Twait //________________________|
+		};
+
+		using input = util::type_list<float>;
+		enum input_attr
+		{
+			Vin
+		};
+
+		// [0, N/2) Poisson neurons, [N/2, 0.9N) excitatory, [0.9N, N) inhibitory LIF neurons
+		enum pop
+		{
+			Poisson,
+			Exc,
+			Inh
+		};
+		static constexpr int_ num_populations = 3;
+		static int_ population( int_ const p, snn_info const info )
+		{
+			switch( p )
+			{
+				case Poisson: return 0;
+				case Exc: return info.num_neurons / 2;
+				case Inh: return static_cast<int>( 0.9f * info.num_neurons );
+				default: return info.num_neurons;
+			}
+		}
+
+		template <typename Iter, typename Backend>
+		HYBRID static void init( Iter n, snn_info, Backend & )
+		{
+			using util::get;
+
+			float const Vrest = 0; // v
+
+			get<V>( n ) = Vrest;
+			get<Twait>( n ) = 0;
+		}
+
+		// dV/dt = ( Vrest - V ) / Tmem
+		static util::linear_dynamics<V> dynamics( snn_info )
+		{
+			double const TmemInv = 1.0 / 0.02; // s
+			double const Vrest = 0.0;          // v
+
+			return { { { -TmemInv } }, { Vrest * TmemInv } };
+		}
+
+		template <int_ P, typename Iter, typename InIter, typename Backend>
+		HYBRID static bool update( Iter n, InIter in, float const dt, snn_info, Backend & bak )
+		{
+			using util::get;
+
+			float const Vrest = 0.0;    // v
+			int_ const Tref = 20;       // dt
+			float const Vthres = 0.02f; // v
+
+			if constexpr( P == Poisson )
+			{
+				float const firing_rate = 20; // Hz
+
+				return bak.rand() < ( firing_rate * dt );
+			}
+			else
+			{
+				// Refractory neurons ignore their input
+				if( get<Twait>( n ) <= 0 ) get<V>( n ) += get<Vin>( in );
+
+				if( --get<Twait>( n ) <= 0 && get<V>( n ) > Vthres )
+				{
+					get<V>( n ) = Vrest;
+					get<Twait>( n ) = Tref;
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		template <int_ P, typename InIter, typename SynIter, typename Backend>
+		HYBRID static void receive(
+		    int_, InIter in, SynIter, model_info<constants_t> const & info, Backend & bak )
+		{
+			using util::get;
+
+			bak.atomic_add( get<Vin>( in ), P == Inh ? info.constants.Win : info.constants.Wex );
+		}
+	};
+};
+} // namespace spice
@@ -8,6 +8,15 @@ namespace spice
 {
 struct brunel_with_plasticity : model
 {
+	struct constants_t
+	{
+		float Wscale; // weights are normalized to a network of 20'000 neurons
+	};
+	static constants_t constants( snn_info const info )
+	{
+		return { 20'000.0f / info.num_neurons };
+	}
+
 	enum neuron_attr
 	{
 		V,
@@ -23,6 +32,25 @@ struct brunel_with_plasticity : model
 
 	struct neuron : ::spice::neuron<float, int_>
 	{
+		// [0, N/2) Poisson neurons, [N/2, 0.9N) excitatory, [0.9N, N) inhibitory LIF neurons
+		enum pop
+		{
+			Poisson,
+			Exc,
+			Inh
+		};
+		static constexpr int_ num_populations = 3;
+		static int_ population( int_ const p, snn_info const info )
+		{
+			switch( p )
+			{
+				case Poisson: return 0;
+				case Exc: return info.num_neurons / 2;
+				case Inh: return static_cast<int>( 0.9f * info.num_neurons );
+				default: return info.num_neurons;
+			}
+		}
+
 		template <typename Iter, typename Backend>
 		HYBRID static void init( Iter n, snn_info, Backend & )
 		{
@@ -34,17 +62,25 @@ struct brunel_with_plasticity : model
 			get<Twait>( n ) = 0;
 		}
 
-		template <typename Iter, typename Backend>
-		HYBRID static bool update( Iter n, float const dt, snn_info info, Backend & bak )
+		// dV/dt = ( Vrest - V ) / Tmem
+		static util::linear_dynamics<V> dynamics( snn_info )
+		{
+			double const TmemInv = 1.0 / 0.02; // s
+			double const Vrest = 0.0;          // v
+
+			return { { { -TmemInv } }, { Vrest * TmemInv } };
+		}
+
+		template <int_ P, typename Iter, typename Backend>
+		HYBRID static bool update( Iter n, float const dt, snn_info, Backend & bak )
 		{
 			using util::get;
 
-			float const TmemInv = 1.0 / 0.02; // s
-			float const Vrest = 0.0;          // v
-			int_ const Tref = 20;              // dt
-			float const Vthres = 0.02f;       // v
+			float const Vrest = 0.0;    // v
+			int_ const Tref = 20;       // dt
+			float const Vthres = 0.02f; // v
 
-			if( n.id() < static_cast<uint_>( info.num_neurons / 2 ) ) // poisson neuron
+			if constexpr( P == Poisson )
 			{
 				float const firing_rate = 20; // Hz
 
@@ -52,29 +88,25 @@ struct brunel_with_plasticity : model
 			}
 			else
 			{
-				if( --get<Twait>( n ) <= 0 )
+				if( --get<Twait>( n ) <= 0 && get<V>( n ) > Vthres )
 				{
-					if( get<V>( n ) > Vthres )
-					{
-						get<V>( n ) = Vrest;
-						get<Twait>( n ) = Tref;
-						return true;
-					}
-
-					get<V>( n ) += ( Vrest - get<V>( n ) ) * ( dt * TmemInv );
+					get<V>( n ) = Vrest;
+					get<Twait>( n ) = Tref;
+					return true;
 				}
 			}
 
 			return false;
 		}
 
-		template <typename Iter, typename SynIter, typename Backend>
-		HYBRID static void receive( int_, Iter dst, SynIter syn, snn_info info, Backend & bak )
+		template <int_, typename Iter, typename SynIter, typename Backend>
+		HYBRID static void receive(
+		    int_, Iter dst, SynIter syn, model_info<constants_t> const & info, Backend & bak )
 		{
 			using util::get;
 
 			if( get<Twait>( dst ) <= 0 )
-				bak.atomic_add( get<V>( dst ), get<W>( syn ) * 20'000 / info.num_neurons );
+				bak.atomic_add( get<V>( dst ), get<W>( syn ) * info.constants.Wscale );
 		}
 	};
 
@@ -88,9 +120,7 @@ struct brunel_with_plasticity : model
 			auto const Wex = 0.0001f;
 			auto const Win = -0.0005f;
 
-			auto const nexc = static_cast<int>( 0.9f * info.num_neurons );
-
-			if( src < nexc )
+			if( src < info.populations[neuron::Inh] )
 				get<W>( syn ) = Wex;
 			else
 				get<W>( syn ) = Win;
@@ -112,10 +142,9 @@ struct brunel_with_plasticity : model
 		{
 			using util::get;
 
-			auto const npoisson = info.num_neurons / 2;
-			auto const nexc = static_cast<int>( 0.9f * info.num_neurons );
-
-			if( src >= npoisson && src < nexc && dst < nexc )
+			// (non-Poisson) excitatory src -> excitatory dst
+			auto const nexc = info.populations[neuron::Inh];
+			if( src >= info.populations[neuron::Exc] && src < nexc && dst < nexc )
 			{
 				float const TstdpInv = 1.0f / 0.02f;
 
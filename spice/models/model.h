@@ -3,6 +3,11 @@
 #include <spice/snn_info.h>
 #include <spice/util/host_defines.h>
 #include <spice/util/meta.h>
+#include <spice/util/propagator.h>
+#include <spice/util/type_traits.h>
+
+#include <type_traits>
+#include <utility>
 
 
 namespace spice
@@ -10,6 +15,35 @@ namespace spice
 template <typename... Ts>
 struct neuron : util::type_list<Ts...>
 {
+	// optional, per-neuron input accumulators. Models which declare some (cpu::snn only) receive
+	// spikes into them instead of their state: receive( src, in, syn, info, bak ) adds to 'in',
+	// update( n, in, dt, info, bak ) consumes it, after which it is reset to 0.
+	using input = util::type_list<>;
+
+	// optional, linear dynamics of (some of) the neuron's attributes, e.g. a leaky membrane's
+	// subthreshold potential. The engine integrates them exactly after every update(), using a
+	// propagator computed once per network (see util::propagator), so update() only has to
+	// handle the rest (thresholds, resets, non-linear terms). update() then always receives the
+	// nominal dt the propagator integrates over, see update_dt().
+	static util::linear_dynamics<> dynamics( snn_info ) { return {}; }
+
+	// optional, no. of populations: contiguous neuron ranges [population( p ), population( p + 1 ))
+	// with distinct dynamics (e.g. Poisson/excitatory/inhibitory). Models which declare some
+	// implement update<P>( ... ) per population P of the updated neuron and receive<P>( ... ) per
+	// population P of the spiking source neuron. Engines dispatch once per range so that neither
+	// has to branch on neuron ids. See update_neuron()/receive_spike() below.
+	static constexpr int_ num_populations = 0;
+	// optional, whether update() draws random no.s (via bak.rand()). Models which never do may
+	// declare false, allowing engines to skip positioning the random stream of every update
+	// (see cpu::ensemble, whose update() receives a backend without rand() then).
+	static constexpr bool stochastic_update = true;
+	// first neuron of population p, p == num_populations yields info.num_neurons. Evaluated once
+	// per network, engines read the boundaries from snn_info::populations.
+	static int_ population( int_ const p, snn_info const info )
+	{
+		return p == 0 ? 0 : info.num_neurons;
+	}
+
 	// optional if layout empty (i.e. 'myneuron : neuron<>')
 	template <typename Iter, typename Backend>
 	HYBRID static void init( Iter, snn_info, Backend & )
@@ -43,8 +77,136 @@ struct synapse : util::type_list<Ts...>
 	}
 };
 
+// Sets info.populations to Neuron's population boundaries
+template <typename Neuron>
+void set_populations( snn_info & info )
+{
+	static_assert( Neuron::num_populations <= snn_info::MAX_POPULATIONS, "too many populations" );
+
+	int_ const n = Neuron::num_populations > 0 ? Neuron::num_populations : 1;
+	for( int_ p = 0; p <= n; p++ ) info.populations[p] = Neuron::population( p, info );
+}
+
+// @return the snn_info of a network of 'num_neurons' Neurons, see snn::info()
+template <typename Neuron>
+snn_info make_snn_info( size_ num_neurons, size_ num_synapses, int_ delay, float dt )
+{
+	snn_info result;
+	result.num_neurons = util::narrow<int>( num_neurons );
+	result.num_synapses = num_synapses;
+	result.delay = delay;
+	result.dt = dt;
+	set_populations<Neuron>( result );
+
+	return result;
+}
+
+// Invokes 'f( P )' with the population of neuron i, P being a std::integral_constant (always 0
+// if Neuron has no populations).
+template <typename Neuron, int_ P = 0, typename F>
+HYBRID void with_population( int_ const i, snn_info const & info, F && f )
+{
+	if constexpr( P + 1 < Neuron::num_populations )
+		if( i >= info.populations[P + 1] )
+			return with_population<Neuron, P + 1>( i, info, std::forward<F>( f ) );
+
+	f( std::integral_constant<int_, P>() );
+}
+
+// Splits the (index) range [first, last) at Neuron's population boundaries and invokes
+// 'f( P, a, b )' for every non-empty piece [a, b) whose neurons 'id( a )', ..., 'id( b - 1 )' all
+// belong to population P. 'id' must be ascending, e.g. sorted spikes.
+template <typename Neuron, int_ P = 0, typename F, typename Id>
+void for_each_population(
+    int_ const first, int_ const last, snn_info const & info, F && f, Id && id )
+{
+	int_ mid = last;
+	if constexpr( P + 1 < Neuron::num_populations )
+	{
+		int_ const end = info.populations[P + 1];
+
+		int_ hi = last;
+		for( mid = first; mid < hi; )
+		{
+			int_ const m = mid + ( hi - mid ) / 2;
+			if( id( m ) < end )
+				mid = m + 1;
+			else
+				hi = m;
+		}
+	}
+
+	if( first < mid ) f( std::integral_constant<int_, P>(), first, mid );
+
+	if constexpr( P + 1 < Neuron::num_populations )
+		for_each_population<Neuron, P + 1>( mid, last, info, std::forward<F>( f ), id );
+}
+// Same as above for the neuron range [first, last)
+template <typename Neuron, typename F>
+void for_each_population( int_ const first, int_ const last, snn_info const & info, F && f )
+{
+	for_each_population<Neuron>( first, last, info, std::forward<F>( f ), []( int_ i ) {
+		return i;
+	} );
+}
+
+// @return the dt to pass to Neuron::update() during a step of length 'dt'. Steps' dt deviates
+// slightly from the nominal 'dt0' (see snn::_step()), while propagators integrate over 'dt0':
+// neurons with linear dynamics receive 'dt0' as well so that both parts of their state advance
+// by the same amount of time.
+template <typename Neuron>
+float update_dt( float const dt, float const dt0 )
+{
+	return util::propagator_t<Neuron>::size > 0 ? dt0 : dt;
+}
+
+// Neuron::update<P>( args... ) if Neuron has populations, Neuron::update( args... ) otherwise
+template <typename Neuron, int_ P = 0, typename... Args>
+HYBRID bool update_neuron( Args &&... args )
+{
+	if constexpr( Neuron::num_populations > 0 )
+		return Neuron::template update<P>( std::forward<Args>( args )... );
+	else
+		return Neuron::template update( std::forward<Args>( args )... );
+}
+// Neuron::receive<P>( args... ) if Neuron has populations, Neuron::receive( args... ) otherwise
+template <typename Neuron, int_ P = 0, typename... Args>
+HYBRID void receive_spike( Args &&... args )
+{
+	if constexpr( Neuron::num_populations > 0 )
+		Neuron::template receive<P>( std::forward<Args>( args )... );
+	else
+		Neuron::template receive( std::forward<Args>( args )... );
+}
+
+// snn_info along with a model's per-network constants (see model::constants()). Engines compute
+// it once per network and pass it to all callbacks, which may take it as a plain snn_info if
+// they have no use for the constants.
+template <typename Constants>
+struct model_info : snn_info
+{
+	Constants constants;
+};
+template <typename Model>
+using info_t = model_info<decltype( Model::constants( snn_info() ) )>;
+
+// @return 'info' along with Model's constants
+template <typename Model>
+info_t<Model> make_info( snn_info const & info )
+{
+	return { info, Model::constants( info ) };
+}
+
 struct model
 {
+	// optional, per-network constants (e.g. weights scaled by the network size), derived from
+	// snn_info once instead of on every callback. Hot callbacks find them in info.constants if
+	// they take a model_info<constants_t>.
+	struct constants_t
+	{
+	};
+	static constants_t constants( snn_info ) { return {}; }
+
 	struct neuron : ::spice::neuron<>
 	{
 	};
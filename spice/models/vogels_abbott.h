@@ -8,6 +8,17 @@ namespace spice
 {
 struct vogels_abbott : model
 {
+	struct constants_t
+	{
+		float Wex; // siemens
+		float Win; // siemens
+	};
+	static constants_t constants( snn_info const info )
+	{
+		return { 0.4f * 16'000'000 / ( (long_)info.num_neurons * info.num_neurons ),
+		         5.1f * 16'000'000 / ( (long_)info.num_neurons * info.num_neurons ) };
+	}
+
 	struct neuron : ::spice::neuron<float, float, float, int_>
 	{             //                  |      |      |     |
 		enum attr //                  |      |      |     |
@@ -18,6 +29,24 @@ struct vogels_abbott : model
 			Twait //______________________________________|
 		};
 
+		// [0, 0.8N) excitatory, [0.8N, N) inhibitory neurons
+		enum pop
+		{
+			Exc,
+			Inh
+		};
+		static constexpr int_ num_populations = 2;
+		static constexpr bool stochastic_update = false;
+		static int_ population( int_ const p, snn_info const info )
+		{
+			switch( p )
+			{
+				case Exc: return 0;
+				case Inh: return static_cast<int>( 0.8f * info.num_neurons );
+				default: return info.num_neurons;
+			}
+		}
+
 		// TODO: replace FAT backend with on-demand (lazy-eval) one
 		template <typename Iter, typename Backend>
 		HYBRID static void init( Iter n, snn_info info, Backend & )
@@ -32,7 +61,16 @@ struct vogels_abbott : model
 			get<Twait>( n ) = 0;
 		}
 
-		template <typename Iter, typename Backend>
+		// Conductances decay exponentially: dGex/dt = -Gex / Tex, dGin/dt = -Gin / Tin
+		static util::linear_dynamics<Gex, Gin> dynamics( snn_info )
+		{
+			double const TexInv = 1.0 / 0.005; // s
+			double const TinInv = 1.0 / 0.01;  // s
+
+			return { { { -TexInv, 0.0 }, { 0.0, -TinInv } }, { 0.0, 0.0 } };
+		}
+
+		template <int_, typename Iter, typename Backend>
 		HYBRID static bool update( Iter n, float const dt, snn_info, Backend & )
 		{
 			using util::get;
@@ -45,9 +83,6 @@ struct vogels_abbott : model
 			float const Ein = -0.08f;           // v
 			float const Ibg = 0.02f;            // v
 
-			float const TexInv = 1.0f / 0.005f; // s
-			float const TinInv = 1.0f / 0.01f;  // s
-
 			bool spiked = false;
 			if( --get<Twait>( n ) <= 0 )
 			{
@@ -64,28 +99,19 @@ struct vogels_abbott : model
 					    ( dt * TmemInv );
 			}
 
-			get<Gex>( n ) -= get<Gex>( n ) * ( dt * TexInv );
-			get<Gin>( n ) -= get<Gin>( n ) * ( dt * TinInv );
-
 			return spiked;
 		}
 
-		template <typename Iter, typename SynIter, typename Backend>
-		HYBRID static void receive( int_ src, Iter dst, SynIter, snn_info info, Backend & bak )
+		template <int_ P, typename Iter, typename SynIter, typename Backend>
+		HYBRID static void
+		receive( int_, Iter dst, SynIter, model_info<constants_t> const & info, Backend & bak )
 		{
 			using util::get;
 
-			float const Wex =
-			    0.4f * 16'000'000 / ( (long_)info.num_neurons * info.num_neurons ); // siemens
-			float const Win =
-			    5.1f * 16'000'000 / ( (long_)info.num_neurons * info.num_neurons ); // siemens
-
-			auto const nexc = static_cast<int>( 0.8f * info.num_neurons );
-
-			if( src < nexc ) // excitatory src neuron
-				bak.atomic_add( get<Gex>( dst ), Wex );
-			else // inhibotory src neuron
-				bak.atomic_add( get<Gin>( dst ), Win );
+			if constexpr( P == Exc )
+				bak.atomic_add( get<Gex>( dst ), info.constants.Wex );
+			else
+				bak.atomic_add( get<Gin>( dst ), info.constants.Win );
 		}
 	};
 };
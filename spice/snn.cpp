@@ -1,6 +1,7 @@
 #include "snn.h"
 
 #include <spice/models/brunel.h>
+#include <spice/models/brunel_with_inputs.h>
 #include <spice/models/brunel_with_plasticity.h>
 #include <spice/models/synth.h>
 #include <spice/models/vogels_abbott.h>
@@ -23,7 +24,7 @@ int_ snn<Model>::delay() const
 template <typename Model>
 snn_info snn<Model>::info() const
 {
-	return { util::narrow_cast<int>( num_neurons() ) };
+	return make_snn_info<typename Model::neuron>( num_neurons(), num_synapses(), delay(), dt() );
 }
 
 template <typename Model>
@@ -36,16 +37,36 @@ snn<Model>::snn( float dt, int_ delay /* = 1 */ )
 }
 
 template <typename Model>
-void snn<Model>::_step( std::function<void( int_, float )> impl )
+void snn<Model>::save( std::string const & ) const
 {
-	spice_assert( _i < std::numeric_limits<decltype( _i )>::max() );
+	spice_assert( false, "backend does not support checkpoints" );
+}
+
+template <typename Model>
+int_ snn<Model>::_num_steps() const
+{
+	return _i;
+}
+
+template <typename Model>
+util::kahan_sum<float> const & snn<Model>::_simulated_time() const
+{
+	return _simtime;
+}
+
+template <typename Model>
+void snn<Model>::_set_clock( int_ const num_steps, util::kahan_sum<float> const simtime )
+{
+	spice_assert( num_steps >= 0 );
 
-	impl( _i++, _simtime.add( dt() ) );
+	_i = num_steps;
+	_simtime = simtime;
 }
 
 
 template class snn<vogels_abbott>;
 template class snn<brunel>;
+template class snn<brunel_with_inputs>;
 template class snn<brunel_with_plasticity>;
 template class snn<synth>;
 } // namespace spice
@@ -2,10 +2,12 @@
 
 #include <spice/snn_info.h>
 #include <spice/util/adj_list.h>
+#include <spice/util/assert.h>
 #include <spice/util/layout.h>
 #include <spice/util/numeric.h>
 
-#include <functional>
+#include <limits>
+#include <string>
 #include <vector>
 
 
@@ -33,9 +35,26 @@ public:
 	virtual std::vector<typename Model::neuron::tuple_t> neurons() const = 0;
 	virtual std::vector<typename Model::synapse::tuple_t> synapses() const = 0;
 
+	// Writes the complete simulation state (graph, neurons, synapses, pending spikes, clock, seed)
+	// to a single file. Not supported by all backends, see cpu::snn for restoring it.
+	virtual void save( std::string const & path ) const;
+
 protected:
 	explicit snn( float dt, int_ delay = 1 );
-	void _step( std::function<void( int_, float )> impl );
+	// Invokes 'impl( istep, dt )' for the next step. A template (rather than std::function) so
+	// that backends' step loops can inline it.
+	template <typename F>
+	void _step( F && impl )
+	{
+		spice_assert( _i < std::numeric_limits<decltype( _i )>::max() );
+
+		impl( _i++, _simtime.add( dt() ) );
+	}
+	// no. of steps simulated so far
+	int_ _num_steps() const;
+	// (checkpoints) simulated time
+	util::kahan_sum<float> const & _simulated_time() const;
+	void _set_clock( int_ num_steps, util::kahan_sum<float> simtime );
 
 private:
 	float const _dt;
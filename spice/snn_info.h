@@ -5,11 +5,22 @@
 
 namespace spice
 {
+// Network-wide quantities, computed once per network (see snn::info()) and passed to all model
+// callbacks
 struct snn_info
 {
+	static constexpr int_ MAX_POPULATIONS = 7;
+
 	int_ num_neurons = 0;
-	// num_synapses
-	// delay
-	// ...
+	// no. of actual edges, excl. the padding of the (ELL) adjacency list returned by snn::adj().
+	// A partition (see cpu::snn) only counts the edges into its range.
+	size_ num_synapses = 0;
+	// (base) delay in steps
+	int_ delay = 0;
+	// nominal time step in s. Steps' actual dt (passed to update()) may deviate from it slightly.
+	float dt = 0.0f;
+	// population boundaries: population p spans [populations[p], populations[p + 1]), see
+	// neuron::population(). Models without populations have a single one.
+	int_ populations[MAX_POPULATIONS + 1] = {};
 };
 } // namespace spice
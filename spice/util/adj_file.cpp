@@ -0,0 +1,112 @@
+#include <spice/util/adj_file.h>
+
+#include <spice/util/assert.h>
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+
+struct adj_header
+{
+	char magic[8];
+	uint_ version;
+	// 0: ELL, 1: CSR
+	uint_ csr;
+
+	ulong_ num_nodes;
+	// ELL only, row width
+	ulong_ max_degree;
+	// incl. padding
+	ulong_ num_edges;
+
+	// in bytes, from the beginning of the file (offsets: CSR only)
+	ulong_ offsets_offset;
+	ulong_ edges_offset;
+};
+
+static char const MAGIC[8] = "SPICEAJ";
+static uint_ const VERSION = 1;
+static size_ const PAGE_SIZE = 4096;
+
+
+namespace spice::util
+{
+adj_file::adj_file( std::string const & path, int_ const num_threads /* = 1 */ )
+    : _file( std::make_shared<mapped_file>( path ) )
+{
+	spice_assert( _file->size() >= sizeof( adj_header ), "not an adjacency file" );
+
+	auto const & h = *reinterpret_cast<adj_header const *>( _file->data() );
+	spice_assert( !std::memcmp( h.magic, MAGIC, 8 ), "not an adjacency file" );
+	spice_assert( h.version == VERSION, "unsupported adjacency file version" );
+	spice_assert(
+	    h.edges_offset + h.num_edges * sizeof( int_ ) <= _file->size() &&
+	        ( !h.csr || h.offsets_offset + ( h.num_nodes + 1 ) * sizeof( size_ ) <= _file->size() ),
+	    "truncated adjacency file" );
+
+	auto const edges = reinterpret_cast<int_ const *>( _file->data() + h.edges_offset );
+	if( h.csr )
+	{
+		auto const offsets = reinterpret_cast<size_ const *>( _file->data() + h.offsets_offset );
+		spice_assert( offsets[h.num_nodes] == h.num_edges, "corrupt adjacency file" );
+
+		_adj = { h.num_nodes, offsets, edges };
+	}
+	else
+	{
+		spice_assert( h.num_nodes * h.max_degree == h.num_edges, "corrupt adjacency file" );
+
+		_adj = { h.num_nodes, h.max_degree, edges };
+	}
+
+	// Files may come from elsewhere: users index arrays with these ids without further checks.
+	_adj.validate( num_threads );
+}
+
+// static
+void adj_file::write( std::string const & path, adj_list const & adj )
+{
+	adj.validate();
+
+	auto const align = []( size_ const x ) {
+		return ( x + PAGE_SIZE - 1 ) / PAGE_SIZE * PAGE_SIZE;
+	};
+
+	bool const csr = adj.offsets();
+	size_ const offsets_bytes = csr ? ( adj.num_nodes() + 1 ) * sizeof( size_ ) : 0;
+
+	adj_header h{};
+	std::memcpy( h.magic, MAGIC, 8 );
+	h.version = VERSION;
+	h.csr = csr;
+	h.num_nodes = adj.num_nodes();
+	h.max_degree = csr ? 0 : adj.max_degree();
+	h.num_edges = adj.num_edges();
+	h.offsets_offset = csr ? align( sizeof( h ) ) : 0;
+	h.edges_offset = align( csr ? h.offsets_offset + offsets_bytes : sizeof( h ) );
+
+	std::FILE * f = std::fopen( path.c_str(), "wb" );
+	if( !f ) throw std::runtime_error( "failed to open '" + path + "' for writing" );
+
+	static char const zeros[PAGE_SIZE] = {};
+	auto const pad = [&]( size_ const from, size_ const to ) {
+		return std::fwrite( zeros, 1, to - from, f ) == to - from;
+	};
+
+	bool ok = std::fwrite( &h, sizeof( h ), 1, f ) == 1;
+	if( csr )
+		ok = ok && pad( sizeof( h ), h.offsets_offset ) &&
+		     std::fwrite( adj.offsets(), sizeof( size_ ), adj.num_nodes() + 1, f ) ==
+		         adj.num_nodes() + 1 &&
+		     pad( h.offsets_offset + offsets_bytes, h.edges_offset );
+	else
+		ok = ok && pad( sizeof( h ), h.edges_offset );
+	ok = ok && std::fwrite( adj.edges(), sizeof( int_ ), h.num_edges, f ) == h.num_edges;
+	ok = !std::fclose( f ) && ok;
+
+	if( !ok ) throw std::runtime_error( "failed to write '" + path + "'" );
+}
+
+adj_list const & adj_file::adj() const { return _adj; }
+} // namespace spice::util
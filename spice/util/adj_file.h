@@ -0,0 +1,38 @@
+#pragma once
+
+#include <spice/util/adj_list.h>
+#include <spice/util/mapped_file.h>
+
+#include <memory>
+#include <string>
+
+
+namespace spice
+{
+namespace util
+{
+// On-disk adjacency lists, for large fixed graphs that should not be regenerated (or copied) on
+// every start. File format: a header (see adj_file.cpp) followed by the (CSR only) offsets
+// (uint64) and the edges (int32), each aligned to a page boundary so they can be used straight
+// from a memory mapping. Every node's neighbors must be sorted in ascending order.
+//
+// Opening a file maps it into memory and validates the graph (on 'num_threads' threads), which
+// reads it once; all processes opening the same file share its pages via the page cache.
+// Copies share the same mapping.
+class adj_file
+{
+public:
+	explicit adj_file( std::string const & path, int_ num_threads = 1 );
+
+	// Writes 'adj' in its own format (ELL or CSR)
+	static void write( std::string const & path, adj_list const & adj );
+
+	// view into the mapping, valid as long as (a copy of) this adj_file exists
+	adj_list const & adj() const;
+
+private:
+	std::shared_ptr<mapped_file const> _file;
+	adj_list _adj;
+};
+} // namespace util
+} // namespace spice
@@ -1,9 +1,11 @@
 #include <spice/cuda/util/defs.h>
+#include <spice/cpu/util/thread_pool.h>
 #include <spice/util/adj_list.h>
 #include <spice/util/assert.h>
 #include <spice/util/random.h>
 #include <spice/util/type_traits.h>
 
+#include <algorithm>
 #include <ctime>
 #include <numeric>
 
@@ -11,8 +13,63 @@
 static ulong_ _seed = 1337;
 
 
+// Samples the neighbors of node i in ascending order. For every connection, 'alloc( degree )'
+// must return a buffer to write 'degree' neighbor ids to. Returns the degree of i.
+template <typename Gen, typename Alloc>
+static size_ generate_row(
+    spice::util::layout const & desc,
+    int_ const i,
+    size_ const max_degree,
+    Gen & gen,
+    Alloc && alloc )
+{
+	using namespace spice::util;
+
+	int_ total_degree = 0;
+	for( auto const & c : desc.connections() )
+	{
+		if( i < std::get<0>( c ) || i >= std::get<1>( c ) ) continue;
+
+		int_ const first = std::get<2>( c );
+		int_ const range = std::get<3>( c ) - first;
+
+		int_ const degree = std::min(
+		    narrow<int>( max_degree - total_degree ), binornd( gen, range, std::get<4>( c ) ) );
+
+		total_degree += degree;
+
+		int_ * const row = alloc( degree );
+		float * neighbor_ids = reinterpret_cast<float *>( row );
+
+		float total = exprnd( gen );
+		for( int_ k = 0; k < degree; k++ )
+		{
+			neighbor_ids[k] = total;
+			total += exprnd( gen );
+		}
+
+		float const scale = ( range - degree ) / total;
+		for( int_ k = 0; k < degree; k++ )
+			row[k] = first + narrow_cast<int>( neighbor_ids[k] * scale ) + k;
+	}
+
+	return total_degree;
+}
+
+
+// Seed of node i's RNG stream: the i-th element of a Weyl sequence starting at 'seed' (as in
+// splitmix64), hashed. Consecutive seeds thus yield independent graphs (rather than ones whose
+// rows are shifted by one).
+static ulong_ row_seed( ulong_ const seed, int_ const i )
+{
+	return spice::util::hash( seed + 0x9e3779b97f4a7c15ull * ( ulong_( i ) + 1 ) );
+}
+
+
 namespace spice::util
 {
+using spice::cpu::util::thread_pool;
+
 adj_list::adj_list( size_ num_nodes, size_ max_degree, int_ const * edges )
     : _num_nodes( num_nodes )
     , _max_degree( max_degree )
@@ -25,11 +82,31 @@ adj_list::adj_list( size_ num_nodes, size_ max_degree, int_ const * edges )
 	    "no. of edges out of boudns" );
 }
 
+adj_list::adj_list( size_ num_nodes, size_ const * offsets, int_ const * edges )
+    : _num_nodes( num_nodes )
+    , _edges( edges )
+    , _offsets( offsets )
+{
+	spice_assert( num_nodes <= std::numeric_limits<int>::max(), "invalid node count" );
+	spice_assert( offsets, "CSR requires offsets" );
+	spice_assert( offsets[0] == 0, "invalid offsets" );
+	spice_assert(
+	    offsets[num_nodes] <= std::numeric_limits<uint_>::max(), "no. of edges out of boudns" );
+
+	for( size_ i = 0; i < num_nodes; i++ )
+	{
+		spice_assert( offsets[i] <= offsets[i + 1], "invalid offsets" );
+		_max_degree = std::max( _max_degree, offsets[i + 1] - offsets[i] );
+	}
+}
+
 
 nonstd::span<int_ const> adj_list::neighbors( size_ i_node ) const
 {
 	spice_assert( i_node < num_nodes(), "index out of bounds" );
 
+	if( _offsets ) return { _edges + _offsets[i_node], _offsets[i_node + 1] - _offsets[i_node] };
+
 	auto const first = &_edges[i_node * max_degree()];
 
 	std::ptrdiff_t d = narrow<ptrdiff_t>( max_degree() ) - 1;
@@ -38,61 +115,137 @@ nonstd::span<int_ const> adj_list::neighbors( size_ i_node ) const
 	return { first, static_cast<size_>( d + 1 ) };
 }
 
+void adj_list::validate( int_ const num_threads /* = 1 */ ) const
+{
+	int_ const N = narrow<int>( num_nodes() );
+	thread_pool pool( std::max( 1, num_threads ) );
+	pool.parallel_for( num_nodes(), [&]( size_ first, size_ last, int_ ) {
+		for( size_ i = first; i < last; i++ )
+		{
+			auto const row = neighbors( i );
+			bool const valid = std::is_sorted( row.begin(), row.end() ) &&
+			                   ( row.empty() || ( row[0] >= 0 && row[row.size() - 1] < N ) );
+			spice_assert( valid, "neighbors must be sorted and within bounds" );
+		}
+	} );
+}
+
 size_ adj_list::edge_index( size_ i_src, size_ i_dst ) const
 {
 	spice_assert( i_src < num_nodes(), "index out of bounds" );
 	spice_assert( i_dst < neighbors( i_src ).size(), "index out of bounds" );
 
-	return i_src * max_degree() + i_dst;
+	return ( _offsets ? _offsets[i_src] : i_src * max_degree() ) + i_dst;
 }
 
 // static
-void adj_list::generate( layout const & desc, std::vector<int> & edges )
+void adj_list::generate(
+    layout const & desc,
+    std::vector<int> & edges,
+    ulong_ const seed /* = 0 */,
+    int_ const num_threads /* = 1 */ )
 {
 	edges.resize( desc.size() * desc.max_degree() );
 
-	xoroshiro256ss gen( _seed++ );
-
-	int_ const N = narrow<int>( desc.size() );
+	ulong_ const s = seed ? seed : hash( _seed++ );
 
-	size_ offset = 0;
-	for( int_ i = 0; i < N; i++ )
-	{
-		int_ total_degree = 0;
-		for( auto const c : desc.connections() )
+	thread_pool( num_threads ).parallel_for( desc.size(), [&]( size_ first, size_ last, int_ ) {
+		for( size_ i = first; i < last; i++ )
 		{
-			if( i < std::get<0>( c ) || i >= std::get<1>( c ) ) continue;
+			xoroshiro256ss gen( row_seed( s, narrow<int>( i ) ) );
+			int_ * const row = edges.data() + i * desc.max_degree();
+
+			size_ offset = 0;
+			generate_row( desc, narrow<int>( i ), desc.max_degree(), gen, [&]( int_ degree ) {
+				offset += degree;
+				return row + offset - degree;
+			} );
 
-			int_ const first = std::get<2>( c );
-			int_ const range = std::get<3>( c ) - first;
+			std::fill( row + offset, row + desc.max_degree(), -1 );
+		}
+	} );
+}
+
+// static
+void adj_list::generate(
+    layout const & desc,
+    std::vector<int> & edges,
+    std::vector<size_> & offsets,
+    ulong_ const seed /* = 0 */,
+    int_ const num_threads /* = 1 */ )
+{
+	ulong_ const s = seed ? seed : hash( _seed++ );
 
-			int_ const degree = std::min(
-			    narrow<int>( desc.max_degree() - total_degree ),
-			    binornd( gen, range, std::get<4>( c ) ) );
+	// Rows are sampled twice: once to count their edges, once more (from the same streams)
+	// straight into their final place. This costs twice the compute but no more memory than the
+	// result itself.
+	generate_offsets( desc, offsets, s, num_threads );
+	edges.resize( offsets.back() );
 
-			total_degree += degree;
+	thread_pool( num_threads ).parallel_for( desc.size(), [&]( size_ first, size_ last, int_ ) {
+		for( size_ i = first; i < last; i++ )
+		{
+			xoroshiro256ss gen( row_seed( s, narrow<int>( i ) ) );
+			int_ * const row = edges.data() + offsets[i];
+
+			size_ offset = 0;
+			generate_row(
+			    desc, narrow<int>( i ), std::numeric_limits<int>::max(), gen, [&]( int_ degree ) {
+				    offset += degree;
+				    return row + offset - degree;
+			    } );
+		}
+	} );
+}
 
-			float * neighbor_ids = reinterpret_cast<float *>( edges.data() + offset );
+// static
+void adj_list::generate_offsets(
+    layout const & desc,
+    std::vector<size_> & offsets,
+    ulong_ const seed,
+    int_ const num_threads /* = 1 */ )
+{
+	spice_assert( seed, "regenerating edges requires a fixed seed" );
 
-			float total = exprnd( gen );
-			for( int_ k = 0; k < degree; k++ )
-			{
-				neighbor_ids[k] = total;
-				total += exprnd( gen );
-			}
+	offsets.resize( desc.size() + 1 );
+	offsets[0] = 0;
 
-			float const scale = ( range - degree ) / total;
-			for( int_ k = 0; k < degree; k++ )
-				edges[offset++] = first + narrow_cast<int>( neighbor_ids[k] * scale ) + k;
+	thread_pool( num_threads ).parallel_for( desc.size(), [&]( size_ first, size_ last, int_ ) {
+		std::vector<int> row;
+		for( size_ i = first; i < last; i++ )
+		{
+			regenerate( desc, seed, i, row );
+			offsets[i + 1] = row.size();
 		}
+	} );
 
-		while( offset < ( i + 1 ) * desc.max_degree() ) edges[offset++] = -1;
-	}
+	std::partial_sum( offsets.begin(), offsets.end(), offsets.begin() );
+}
+
+// static
+void adj_list::regenerate(
+    layout const & desc, ulong_ const seed, size_ const i_node, std::vector<int> & neighbors )
+{
+	spice_assert( seed, "regenerating edges requires a fixed seed" );
+	spice_assert( i_node < desc.size(), "index out of bounds" );
+
+	neighbors.clear();
+
+	xoroshiro256ss gen( row_seed( seed, narrow<int>( i_node ) ) );
+	generate_row(
+	    desc, narrow<int>( i_node ), std::numeric_limits<int>::max(), gen, [&]( int_ degree ) {
+		    neighbors.resize( neighbors.size() + degree );
+		    return neighbors.data() + neighbors.size() - degree;
+	    } );
 }
 
 int_ const * adj_list::edges() const { return _edges; }
+size_ const * adj_list::offsets() const { return _offsets; }
 
 size_ adj_list::num_nodes() const { return _num_nodes; }
 size_ adj_list::max_degree() const { return _max_degree; }
-size_ adj_list::num_edges() const { return num_nodes() * max_degree(); }
+size_ adj_list::num_edges() const
+{
+	return _offsets ? _offsets[num_nodes()] : num_nodes() * max_degree();
+}
 } // namespace spice::util
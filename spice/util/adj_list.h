@@ -12,27 +12,62 @@ namespace spice
 namespace util
 {
 // view
+// Supports two formats:
+// - ELL: every node's neighbors are stored in a row of fixed width 'max_degree', padded with -1
+// - CSR: node i's neighbors are stored in edges[offsets[i], offsets[i + 1]), without padding
 class adj_list
 {
 public:
 	adj_list() = default;
+	// ELL
 	adj_list( size_ num_nodes, size_ max_degree, int_ const * edges );
+	// CSR, 'offsets' must hold num_nodes + 1 entries
+	adj_list( size_ num_nodes, size_ const * offsets, int_ const * edges );
 
 	nonstd::span<int_ const> neighbors( size_ i_node ) const;
 	size_ edge_index( size_ i_src, size_ i_dst ) const;
+	// Throws unless every node's neighbors are sorted and within [0, num_nodes()).
+	// (Offsets are checked on construction already.)
+	void validate( int_ num_threads = 1 ) const;
 
-	static void generate( layout const & desc, std::vector<int> & edges );
+	// Every node's neighbors are drawn from their own RNG stream derived from 'seed', so the
+	// result only depends on 'desc' and 'seed', not on 'num_threads'.
+	// 'seed' == 0 picks a new seed on every call.
+
+	// ELL, truncates nodes whose degree exceeds desc.max_degree()
+	static void generate(
+	    layout const & desc, std::vector<int> & edges, ulong_ seed = 0, int_ num_threads = 1 );
+	// CSR
+	static void generate(
+	    layout const & desc,
+	    std::vector<int> & edges,
+	    std::vector<size_> & offsets,
+	    ulong_ seed = 0,
+	    int_ num_threads = 1 );
+	// CSR offsets only, without storing any edges. 'seed' must not be 0.
+	static void generate_offsets(
+	    layout const & desc, std::vector<size_> & offsets, ulong_ seed, int_ num_threads = 1 );
+	// Re-samples node i's neighbors (CSR) into 'neighbors', exactly as generate() did for the
+	// same 'desc' and (non-zero) 'seed'. Allows regenerating edges on demand instead of storing
+	// them.
+	static void regenerate(
+	    layout const & desc, ulong_ seed, size_ i_node, std::vector<int> & neighbors );
 
 	int_ const * edges() const;
+	// nullptr for ELL
+	size_ const * offsets() const;
 
 	size_ num_nodes() const;
+	// ELL: row width, CSR: largest degree of any node
 	size_ max_degree() const;
+	// ELL: incl. padding
 	size_ num_edges() const;
 
 private:
 	size_ _num_nodes = 0;
 	size_ _max_degree = 0;
 	int_ const * _edges = nullptr;
+	size_ const * _offsets = nullptr;
 };
 } // namespace util
 } // namespace spice
@@ -5,7 +5,9 @@
 #include <spice/util/stdint.h>
 #include <spice/util/type_traits.h>
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <map>
 #include <numeric>
 
@@ -46,10 +48,22 @@ layout::layout( size_ const num_neurons, float const connections )
 	spice_assert( num_neurons > 0, "layout must contain at least 1 neuron" );
 }
 
+layout::layout(
+    std::vector<size_> const & pops, std::vector<std::tuple<size_, size_, float>> connections )
+    : layout( pops, [&] {
+	    // 0: no delay of its own
+	    std::vector<std::tuple<size_, size_, float, int_>> result;
+	    for( auto [src, dst, p] : connections ) result.push_back( { src, dst, p, 0 } );
+	    return result;
+    }() )
+{
+}
+
 #pragma warning( push )
 #pragma warning( disable : 4189 4457 ) // unreferenced variable 'gs' in assert, hidden variable
 layout::layout(
-    std::vector<size_> const & pops, std::vector<std::tuple<size_, size_, float>> connections )
+    std::vector<size_> const & pops,
+    std::vector<std::tuple<size_, size_, float, int_>> connections )
 {
 	spice_assert( pops.size() > 0, "layout must contain at least 1 (non-empty) population" );
 
@@ -65,6 +79,7 @@ layout::layout(
 		    "invalid index in connections matrix" );
 		spice_assert(
 		    std::get<2>( c ) >= 0.0f && std::get<2>( c ) <= 1.0f, "invalid connect. prob." );
+		spice_assert( std::get<3>( c ) >= 0, "invalid delay" );
 	}
 
 	{
@@ -101,6 +116,7 @@ layout::layout(
 			      narrow<int>( first( std::get<1>( c ) ) ),
 			      narrow<int>( last( std::get<1>( c ) ) ),
 			      std::get<2>( c ) } );
+			_delays.push_back( std::get<3>( c ) );
 		}
 
 		_max_degree = estimate_max_deg( _connections );
@@ -112,8 +128,24 @@ layout::layout(
 
 size_ layout::size() const { return _n; }
 std::vector<layout::edge> const & layout::connections() const { return _connections; }
+std::vector<int_> const & layout::delays() const { return _delays; }
 size_ layout::max_degree() const { return _max_degree; }
 
+int_ layout::min_delay( int_ const delay ) const
+{
+	int_ result = std::numeric_limits<int_>::max();
+	for( int_ d : delays() ) result = std::min( result, d ? d : delay );
+
+	return delays().empty() ? delay : result;
+}
+int_ layout::max_delay( int_ const delay ) const
+{
+	int_ result = 0;
+	for( int_ d : delays() ) result = std::max( result, d ? d : delay );
+
+	return delays().empty() ? delay : result;
+}
+
 std::pair<size_, size_> layout::static_load_balance( size_ const n, size_ const i ) const
 {
 	spice_assert( n > 0 );
@@ -167,14 +199,20 @@ layout::slice<> layout::cut( std::pair<size_, size_> range ) const
 	spice_assert( range.first <= range.second );
 
 	std::vector<layout::edge> part;
-	for( auto c : connections() )
+	std::vector<int_> delays;
+	for( size_ i = 0; i < connections().size(); i++ )
 	{
+		auto c = connections()[i];
 		std::get<2>( c ) = std::max( narrow<int_>( range.first ), std::get<2>( c ) );
 		std::get<3>( c ) = std::min( narrow<int_>( range.second ), std::get<3>( c ) );
-		if( std::get<2>( c ) < std::get<3>( c ) ) part.push_back( std::move( c ) );
+		if( std::get<2>( c ) < std::get<3>( c ) )
+		{
+			part.push_back( std::move( c ) );
+			delays.push_back( _delays[i] );
+		}
 	}
 
-	return { layout( size(), part ), range.first, range.second };
+	return { layout( size(), part, delays ), range.first, range.second };
 }
 
 layout layout::cut( size_ slice_width, size_ n_gpus, size_ i_gpu ) const
@@ -183,24 +221,30 @@ layout layout::cut( size_ slice_width, size_ n_gpus, size_ i_gpu ) const
 	spice_assert( i_gpu < n_gpus );
 
 	std::vector<layout::edge> part;
-	for( auto c : connections() )
+	std::vector<int_> delays;
+	for( size_ i = 0; i < connections().size(); i++ )
 	{
+		auto const & c = connections()[i];
 		for( size_ first = i_gpu * slice_width; first < size(); first += n_gpus * slice_width )
 		{
 			size_ last = first + slice_width;
 			auto const a = std::max( narrow<int_>( first ), std::get<2>( c ) );
 			auto const b = std::min( narrow<int_>( last ), std::get<3>( c ) );
 			if( a < b )
+			{
 				part.push_back( { std::get<0>( c ), std::get<1>( c ), a, b, std::get<4>( c ) } );
+				delays.push_back( _delays[i] );
+			}
 		}
 	}
 
-	return { size(), part };
+	return { size(), part, delays };
 }
 
-layout::layout( size_ n, std::vector<edge> flat )
+layout::layout( size_ n, std::vector<edge> flat, std::vector<int_> delays )
     : _n( n )
     , _connections( flat )
+    , _delays( delays )
     , _max_degree( estimate_max_deg( flat ) )
 {
 }
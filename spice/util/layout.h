@@ -31,11 +31,23 @@ public:
 	layout(
 	    std::vector<size_> const & group_sizes,
 	    std::vector<std::tuple<size_, size_, float>> connectivity );
+	// (src group, dst group, p, delay): every connection has its own delay in steps, or 0 to use
+	// the network's delay
+	layout(
+	    std::vector<size_> const & group_sizes,
+	    std::vector<std::tuple<size_, size_, float, int_>> connectivity );
 
 	size_ size() const;
 	std::vector<edge> const & connections() const;
+	// delay of connections()[i], 0 if it has none (i.e. uses the network's delay)
+	std::vector<int_> const & delays() const;
 	size_ max_degree() const;
 
+	// @return the smallest/largest delay of any connection, substituting 'delay' for connections
+	// without one ('delay' if there are no connections)
+	int_ min_delay( int_ delay ) const;
+	int_ max_delay( int_ delay ) const;
+
 	std::pair<size_, size_> static_load_balance( size_ n, size_ i ) const;
 	template <typename T = layout>
 	struct slice
@@ -51,9 +63,10 @@ public:
 private:
 	size_ _n;
 	std::vector<edge> _connections;
+	std::vector<int_> _delays;
 	size_ _max_degree;
 
-	layout( size_ n, std::vector<edge> flat );
+	layout( size_ n, std::vector<edge> flat, std::vector<int_> delays );
 };
 } // namespace util
 } // namespace spice
@@ -0,0 +1,76 @@
+#include <spice/util/mapped_file.h>
+
+#include <algorithm>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+
+#if __has_include( <sys/mman.h> )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SPICE_HAS_MMAP
+#endif
+
+
+static size_ const PAGE_SIZE = 4096;
+
+
+namespace spice::util
+{
+mapped_file::mapped_file( std::string const & path )
+{
+#ifdef SPICE_HAS_MMAP
+	int const fd = ::open( path.c_str(), O_RDONLY );
+	if( fd >= 0 )
+	{
+		struct stat st;
+		if( !::fstat( fd, &st ) && st.st_size > 0 )
+		{
+			void * p = ::mmap( nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+			if( p != MAP_FAILED )
+			{
+				_data = static_cast<char *>( p );
+				_size = st.st_size;
+				_mapped = true;
+			}
+		}
+		::close( fd );
+	}
+#endif
+
+	if( !_mapped )
+	{
+		std::ifstream f( path, std::ios::binary | std::ios::ate );
+		if( !f ) throw std::runtime_error( "failed to open '" + path + "'" );
+
+		_size = f.tellg();
+		_data = static_cast<char *>(
+		    ::operator new( std::max( _size, size_( 1 ) ), std::align_val_t{ PAGE_SIZE } ) );
+
+		f.seekg( 0 );
+		if( !f.read( _data, _size ) )
+		{
+			::operator delete( _data, std::align_val_t{ PAGE_SIZE } );
+			throw std::runtime_error( "failed to read '" + path + "'" );
+		}
+	}
+}
+
+mapped_file::~mapped_file()
+{
+#ifdef SPICE_HAS_MMAP
+	if( _mapped )
+	{
+		::munmap( _data, _size );
+		return;
+	}
+#endif
+	::operator delete( _data, std::align_val_t{ PAGE_SIZE } );
+}
+
+char * mapped_file::data() { return _data; }
+char const * mapped_file::data() const { return _data; }
+size_ mapped_file::size() const { return _size; }
+} // namespace spice::util
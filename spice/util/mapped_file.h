@@ -0,0 +1,34 @@
+#pragma once
+
+#include <spice/util/stdint.h>
+
+#include <memory>
+#include <string>
+
+
+namespace spice
+{
+namespace util
+{
+// Maps an entire file into memory (privately: writes are never carried through to the file).
+// Falls back to reading the file into (page-aligned) memory where mmap is unavailable.
+class mapped_file
+{
+public:
+	explicit mapped_file( std::string const & path );
+	~mapped_file();
+
+	mapped_file( mapped_file const & ) = delete;
+	mapped_file & operator=( mapped_file const & ) = delete;
+
+	char * data();
+	char const * data() const;
+	size_ size() const;
+
+private:
+	char * _data = nullptr;
+	size_ _size = 0;
+	bool _mapped = false;
+};
+} // namespace util
+} // namespace spice
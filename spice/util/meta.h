@@ -6,6 +6,7 @@
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 
 #pragma warning( push )
@@ -169,6 +170,13 @@ struct soa_t
 		return 0;
 	}
 
+	// Invokes 'f( cont )' for every attribute's container
+	template <typename Fn>
+	void for_each_attr( Fn && f )
+	{
+		util::for_each( _data, std::forward<Fn>( f ) );
+	}
+
 	std::vector<typename TypeList::tuple_t> to_aos() const
 	{
 		std::vector<typename TypeList::tuple_t> result( size() );
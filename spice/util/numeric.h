@@ -9,6 +9,14 @@ template <typename Prec>
 class kahan_sum
 {
 public:
+	kahan_sum() = default;
+	// Resumes a sum, see residue()
+	kahan_sum( Prec sum, Prec residue )
+	    : _c( residue )
+	    , _sum( sum )
+	{
+	}
+
 	// Adds delta to the sum. Returns the actual delta added (delta - residue)
 #ifdef __GNUC__
 	__attribute__( ( optimize( "-fno-fast-math" ) ) )
@@ -26,6 +34,8 @@ public:
 
 	// Returns total sum
 	operator Prec() const { return _sum; }
+	// Returns the compensation still to be applied to the next delta
+	Prec residue() const { return _c; }
 
 private:
 	Prec _c = 0;
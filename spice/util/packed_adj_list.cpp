@@ -0,0 +1,73 @@
+#include <spice/util/packed_adj_list.h>
+
+#include <spice/util/assert.h>
+#include <spice/util/type_traits.h>
+
+
+namespace spice::util
+{
+packed_adj_list::packed_adj_list( adj_list const & adj )
+    : _width( adj.offsets() ? 0 : adj.max_degree() )
+{
+	size_ const N = adj.num_nodes();
+
+	_offsets.resize( N + 1 );
+	_rows.resize( N + 1 );
+	_offsets[0] = 0;
+	_rows[0] = 0;
+
+	for( size_ i = 0; i < N; i++ )
+	{
+		auto const row = adj.neighbors( i );
+
+		for( size_ j = 0; j < row.size(); j += BLOCK )
+		{
+			size_ const n = std::min( BLOCK, row.size() - j );
+
+			uint_ max_gap = 0;
+			for( size_ k = j + 1; k < j + n; k++ )
+			{
+				spice_assert( row[k - 1] <= row[k], "neighbors must be sorted" );
+				max_gap = std::max( max_gap, narrow<uint_>( row[k] - row[k - 1] ) );
+			}
+
+			uint_ w = 0;
+			while( w < 32 && max_gap >> w ) w++;
+
+			spice_assert( row[j] >= 0, "invalid neighbor" );
+			_data.push_back( row[j] );
+			_data.push_back( w );
+
+			size_ const first = _data.size();
+			_data.resize( first + ( ( n - 1 ) * w + 31 ) / 32 );
+			for( size_ k = 1; k < n; k++ )
+			{
+				size_ const bit = ( k - 1 ) * w;
+				ulong_ const gap = narrow<uint_>( row[j + k] - row[j + k - 1] );
+
+				_data[first + bit / 32] |= static_cast<uint_>( gap << ( bit % 32 ) );
+				if( bit % 32 + w > 32 )
+					_data[first + bit / 32 + 1] |= static_cast<uint_>( gap >> ( 32 - bit % 32 ) );
+			}
+		}
+
+		_offsets[i + 1] = _offsets[i] + row.size();
+		_rows[i + 1] = _data.size();
+	}
+}
+
+size_ packed_adj_list::edge_index( size_ i_src, size_ i_dst ) const
+{
+	spice_assert( i_src < num_nodes(), "index out of bounds" );
+	spice_assert( i_dst < _offsets[i_src + 1] - _offsets[i_src], "index out of bounds" );
+
+	return ( _width ? i_src * _width : _offsets[i_src] ) + i_dst;
+}
+
+size_ packed_adj_list::num_nodes() const { return _rows.empty() ? 0 : _rows.size() - 1; }
+size_ packed_adj_list::num_edges() const { return _offsets.empty() ? 0 : _offsets.back(); }
+size_ packed_adj_list::size_in_bytes() const
+{
+	return ( _offsets.size() + _rows.size() ) * sizeof( size_ ) + _data.size() * sizeof( uint_ );
+}
+} // namespace spice::util
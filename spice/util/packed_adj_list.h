@@ -0,0 +1,96 @@
+#pragma once
+
+#include <spice/util/adj_list.h>
+#include <spice/util/stdint.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+
+namespace spice
+{
+namespace util
+{
+// Compressed copy of an adj_list whose neighbor lists are sorted in ascending order. Every
+// node's neighbors are split into blocks of BLOCK ids. A block is stored as its first id (base),
+// the bit width w of its largest gap, and the gaps between its consecutive ids, packed into w
+// bits each (LSB first, rounded up to whole words). Gaps are typically much smaller than ids,
+// so edges take 2-4x fewer bytes. Decoding is scalar (shifts, masks and adds per id), so whether
+// this pays off depends on how memory-bound visiting edges is.
+class packed_adj_list
+{
+public:
+	static size_ const BLOCK = 32;
+
+	packed_adj_list() = default;
+	explicit packed_adj_list( adj_list const & adj );
+
+	// Invokes 'f( j, dst )' for every neighbor 'dst' of node i that lies in [first, last),
+	// in ascending order, along with its position j in i's neighbor list. Skips (without
+	// decoding) all blocks outside of [first, last).
+	template <typename F>
+	void for_each_neighbor(
+	    size_ const i,
+	    F && f,
+	    int_ const first = 0,
+	    int_ const last = std::numeric_limits<int_>::max() ) const
+	{
+		size_ const degree = _offsets[i + 1] - _offsets[i];
+		uint_ const * block = _data.data() + _rows[i];
+
+		int_ ids[BLOCK];
+		for( size_ j = 0; j < degree; j += BLOCK )
+		{
+			size_ const n = std::min( BLOCK, degree - j );
+			int_ const base = block[0];
+			uint_ const w = block[1];
+			uint_ const * const gaps = block + 2;
+			block = gaps + ( ( n - 1 ) * w + 31 ) / 32;
+
+			if( base >= last ) break;
+			// All ids of this block are <= the next block's base
+			if( j + n < degree && static_cast<int_>( block[0] ) < first ) continue;
+
+			// Unpack and prefix-sum the gaps, refilling a 64-bit bit buffer one word at a time
+			ulong_ const mask = ( ulong_( 1 ) << w ) - 1;
+			ulong_ bits = 0;
+			uint_ avail = 0;
+			uint_ const * word = gaps;
+			ids[0] = base;
+			for( size_ k = 1; k < n; k++ )
+			{
+				if( avail < w )
+				{
+					bits |= ulong_( *word++ ) << avail;
+					avail += 32;
+				}
+				ids[k] = ids[k - 1] + static_cast<int_>( bits & mask );
+				bits >>= w;
+				avail -= w;
+			}
+
+			for( size_ k = 0; k < n; k++ )
+				if( ids[k] >= first && ids[k] < last ) f( j + k, ids[k] );
+		}
+	}
+
+	// same as adj_list::edge_index() of the original list
+	size_ edge_index( size_ i_src, size_ i_dst ) const;
+
+	size_ num_nodes() const;
+	// excl. padding
+	size_ num_edges() const;
+	size_ size_in_bytes() const;
+
+private:
+	// (ELL only) row width of the original list, so edge indices match
+	size_ _width = 0;
+	// node i's neighbors are neighbors [_offsets[i], _offsets[i + 1]) of the CSR representation
+	std::vector<size_> _offsets;
+	// node i's blocks start at word _rows[i] of _data
+	std::vector<size_> _rows;
+	std::vector<uint_> _data;
+};
+} // namespace util
+} // namespace spice
@@ -0,0 +1,31 @@
+#include <spice/util/procedural_adj_list.h>
+
+#include <spice/util/assert.h>
+
+
+namespace spice::util
+{
+procedural_adj_list::procedural_adj_list(
+    layout const & desc, ulong_ const seed, int_ const num_threads /* = 1 */ )
+    : _desc( desc )
+    , _seed( seed )
+{
+	adj_list::generate_offsets( desc, _offsets, seed, num_threads );
+
+	for( size_ i = 0; i < desc.size(); i++ )
+		_max_degree = std::max( _max_degree, _offsets[i + 1] - _offsets[i] );
+}
+
+size_ procedural_adj_list::edge_index( size_ i_src, size_ i_dst ) const
+{
+	spice_assert( i_src < num_nodes(), "index out of bounds" );
+	spice_assert( i_dst < _offsets[i_src + 1] - _offsets[i_src], "index out of bounds" );
+
+	return _offsets[i_src] + i_dst;
+}
+
+size_ procedural_adj_list::num_nodes() const { return _offsets.empty() ? 0 : _offsets.size() - 1; }
+size_ procedural_adj_list::num_edges() const { return _offsets.empty() ? 0 : _offsets.back(); }
+size_ procedural_adj_list::max_degree() const { return _max_degree; }
+size_ const * procedural_adj_list::offsets() const { return _offsets.data(); }
+} // namespace spice::util
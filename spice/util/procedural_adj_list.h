@@ -0,0 +1,59 @@
+#pragma once
+
+#include <spice/util/adj_list.h>
+#include <spice/util/layout.h>
+#include <spice/util/stdint.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+
+namespace spice
+{
+namespace util
+{
+// Graph generated by adj_list::generate() (CSR) which does not store its edges: every node's
+// neighbors are re-sampled from the node's own RNG stream whenever they are visited. Only stores
+// the CSR offsets (O(1) memory per node), trading compute for memory capacity and bandwidth.
+class procedural_adj_list
+{
+public:
+	// Same graph as adj_list::generate( desc, *, *, seed ), 'seed' must not be 0
+	procedural_adj_list( layout const & desc, ulong_ seed, int_ num_threads = 1 );
+
+	// Invokes 'f( j, dst )' for every neighbor 'dst' of node i that lies in [first, last),
+	// in ascending order, along with its position j in i's neighbor list. Thread-safe.
+	template <typename F>
+	void for_each_neighbor(
+	    size_ const i,
+	    F && f,
+	    int_ const first = 0,
+	    int_ const last = std::numeric_limits<int_>::max() ) const
+	{
+		thread_local std::vector<int> row;
+		adj_list::regenerate( _desc, _seed, i, row );
+
+		auto const a = std::lower_bound( row.begin(), row.end(), first );
+		auto const b = std::lower_bound( a, row.end(), last );
+		for( auto it = a; it != b; ++it ) f( static_cast<size_>( it - row.begin() ), *it );
+	}
+
+	// same as adj_list::edge_index() of the generated list
+	size_ edge_index( size_ i_src, size_ i_dst ) const;
+
+	size_ num_nodes() const;
+	size_ num_edges() const;
+	// largest degree of any node
+	size_ max_degree() const;
+	// num_nodes() + 1 entries
+	size_ const * offsets() const;
+
+private:
+	layout _desc;
+	ulong_ _seed = 0;
+	std::vector<size_> _offsets;
+	size_ _max_degree = 0;
+};
+} // namespace util
+} // namespace spice
@@ -0,0 +1,61 @@
+#include <spice/util/propagator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+// c = a * b, all n x n
+static void mul( double const * a, double const * b, double * c, size_ const n )
+{
+	for( size_ i = 0; i < n; i++ )
+		for( size_ j = 0; j < n; j++ )
+		{
+			double sum = 0.0;
+			for( size_ k = 0; k < n; k++ ) sum += a[i * n + k] * b[k * n + j];
+			c[i * n + j] = sum;
+		}
+}
+
+
+namespace spice::util
+{
+void expm( double * const m, size_ const n )
+{
+	// Scale m down to a norm < 0.5, sum the Taylor series, square the result back up
+	double norm = 0.0;
+	for( size_ i = 0; i < n; i++ )
+	{
+		double row = 0.0;
+		for( size_ j = 0; j < n; j++ ) row += std::abs( m[i * n + j] );
+		norm = std::max( norm, row );
+	}
+
+	int_ const squarings =
+	    norm > 0.5 ? static_cast<int_>( std::ceil( std::log2( norm / 0.5 ) ) ) : 0;
+	double const scale = std::ldexp( 1.0, -squarings );
+
+	std::vector<double> a( m, m + n * n ), term( n * n, 0.0 ), sum( n * n, 0.0 ), tmp( n * n );
+	for( double & x : a ) x *= scale;
+	for( size_ i = 0; i < n; i++ ) term[i * n + i] = sum[i * n + i] = 1.0;
+
+	// ||a||^k / k! < 0.5^k / k! drops below double precision well before k = 20
+	for( int_ k = 1; k <= 20; k++ )
+	{
+		mul( term.data(), a.data(), tmp.data(), n );
+		for( size_ i = 0; i < n * n; i++ )
+		{
+			term[i] = tmp[i] / k;
+			sum[i] += term[i];
+		}
+	}
+
+	for( int_ i = 0; i < squarings; i++ )
+	{
+		mul( sum.data(), sum.data(), tmp.data(), n );
+		sum.swap( tmp );
+	}
+
+	std::copy( sum.begin(), sum.end(), m );
+}
+} // namespace spice::util
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <spice/snn_info.h>
+#include <spice/util/host_defines.h>
+#include <spice/util/meta.h>
+#include <spice/util/stdint.h>
+
+#include <type_traits>
+
+
+namespace spice
+{
+namespace util
+{
+// exp( m ) of the row-major n x n matrix 'm', in place
+void expm( double * m, size_ n );
+
+template <int_... I>
+class propagator;
+
+// Linear dynamics dx/dt = A x + b of the neuron attributes x = ( I... ), e.g. a leaky membrane's
+// subthreshold potential or exponentially decaying conductances. See neuron::dynamics().
+template <int_... I>
+struct linear_dynamics
+{
+	static constexpr size_ size = sizeof...( I );
+	using propagator_t = propagator<I...>;
+
+	double A[size > 0 ? size : 1][size > 0 ? size : 1] = {};
+	double b[size > 0 ? size : 1] = {};
+};
+
+// Exact solution of linear_dynamics over a fixed time step: x( t + dt ) = P x( t ) + q with
+// P = exp( A dt ). Computed once (on the host), applied to every neuron every step.
+template <int_... I>
+class propagator
+{
+public:
+	static constexpr size_ size = sizeof...( I );
+
+	// identity
+	propagator()
+	{
+		for( size_ r = 0; r < size; r++ ) _P[r][r] = 1.0f;
+	}
+
+	propagator( linear_dynamics<I...> const & sys, float const dt )
+	{
+		// exp( [A b; 0 0] dt ) = [P q; 0 1]
+		size_ const n = size + 1;
+		double m[( size + 1 ) * ( size + 1 )] = {};
+		for( size_ r = 0; r < size; r++ )
+		{
+			for( size_ c = 0; c < size; c++ ) m[r * n + c] = sys.A[r][c] * dt;
+			m[r * n + size] = sys.b[r] * dt;
+		}
+
+		expm( m, n );
+
+		for( size_ r = 0; r < size; r++ )
+		{
+			for( size_ c = 0; c < size; c++ ) _P[r][c] = static_cast<float>( m[r * n + c] );
+			_q[r] = static_cast<float>( m[r * n + size] );
+		}
+	}
+
+	// Advances the attributes ( I... ) of neuron 'n' by dt
+	template <typename Iter>
+	HYBRID void apply( Iter n ) const
+	{
+		if constexpr( size > 0 )
+		{
+			float const x[] = { static_cast<float>( get<I>( n ) )... };
+
+			size_ r = 0;
+			( ( get<I>( n ) = static_cast<std::remove_reference_t<decltype( get<I>( n ) )>>(
+			        _row( r++, x ) ) ),
+			  ... );
+		}
+	}
+
+private:
+	float _P[size > 0 ? size : 1][size > 0 ? size : 1] = {};
+	float _q[size > 0 ? size : 1] = {};
+
+	HYBRID float _row( size_ const r, float const * x ) const
+	{
+		float result = _q[r];
+		for( size_ c = 0; c < size; c++ ) result += _P[r][c] * x[c];
+		return result;
+	}
+};
+
+// propagator of Neuron's linear dynamics, see neuron::dynamics()
+template <typename Neuron>
+using propagator_t = typename decltype( Neuron::dynamics( snn_info() ) )::propagator_t;
+} // namespace util
+} // namespace spice
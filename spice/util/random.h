@@ -68,8 +68,45 @@ public:
 		return result;
 	}
 
+	// Equivalent to 2^64 calls to operator(), generates 2^64 non-overlapping sub-sequences
+	HYBRID inline void jump()
+	{
+		uint_ const JUMP[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+		_jump( JUMP );
+	}
+
+	// Equivalent to 2^96 calls to operator(), generates 2^32 starting points from each of which
+	// jump() generates 2^32 non-overlapping sub-sequences
+	HYBRID inline void long_jump()
+	{
+		uint_ const LONG_JUMP[] = { 0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662 };
+		_jump( LONG_JUMP );
+	}
+
 private:
 	uint_ s0, s1, s2, s3;
+
+	HYBRID inline void _jump( uint_ const ( &poly )[4] )
+	{
+		uint_ t0 = 0, t1 = 0, t2 = 0, t3 = 0;
+		for( uint_ word : poly )
+			for( int_ b = 0; b < 32; b++ )
+			{
+				if( word & ( 1u << b ) )
+				{
+					t0 ^= s0;
+					t1 ^= s1;
+					t2 ^= s2;
+					t3 ^= s3;
+				}
+				( *this )();
+			}
+
+		s0 = t0;
+		s1 = t1;
+		s2 = t2;
+		s3 = t3;
+	}
 };
 
 // http://prng.di.unimi.it/xoshiro256starstar.c
@@ -108,8 +145,122 @@ public:
 		return result;
 	}
 
+	// Equivalent to 2^128 calls to operator(), generates 2^128 non-overlapping sub-sequences
+	HYBRID inline void jump()
+	{
+		ulong_ const JUMP[] = { 0x180ec6d33cfd0aballu,
+		                        0xd5a61266f0c9392cllu,
+		                        0xa9582618e03fc9aallu,
+		                        0x39abdc4529b1661cllu };
+		_jump( JUMP );
+	}
+
+	// Equivalent to 2^192 calls to operator(), generates 2^64 starting points from each of which
+	// jump() generates 2^64 non-overlapping sub-sequences
+	HYBRID inline void long_jump()
+	{
+		ulong_ const LONG_JUMP[] = { 0x76e15d3efefdcbbfllu,
+		                             0xc5004e441c522fb3llu,
+		                             0x77710069854ee241llu,
+		                             0x39109bb02acbe635llu };
+		_jump( LONG_JUMP );
+	}
+
 private:
 	ulong_ s0, s1, s2, s3;
+
+	HYBRID inline void _jump( ulong_ const ( &poly )[4] )
+	{
+		ulong_ t0 = 0, t1 = 0, t2 = 0, t3 = 0;
+		for( ulong_ word : poly )
+			for( int_ b = 0; b < 64; b++ )
+			{
+				if( word & ( 1llu << b ) )
+				{
+					t0 ^= s0;
+					t1 ^= s1;
+					t2 ^= s2;
+					t3 ^= s3;
+				}
+				( *this )();
+			}
+
+		s0 = t0;
+		s1 = t1;
+		s2 = t2;
+		s3 = t3;
+	}
+};
+
+// Counter-based generator, http://www.thesalmons.org/john/random123/papers/random123sc11.pdf
+// Every block of 4 random no.s is a pure function of a 128-bit counter and a 64-bit key, which
+// allows any no. of independent streams to be drawn from without coordination: Counter words
+// 1-3 identify the stream (see seek()), word 0 enumerates the (2^32) blocks within it.
+class philox4x32_10
+{
+public:
+	using result_type = uint_;
+	constexpr uint_ min() { return 0; }
+	constexpr uint_ max() { return std::numeric_limits<uint_>::max(); }
+
+	HYBRID inline explicit philox4x32_10( ulong_ key )
+	    : _key{ (uint_)key, ( uint_ )( key >> 32 ) }
+	{
+	}
+
+	// Continues with the first no. of stream (c1, c2, c3)
+	HYBRID inline void seek( uint_ c1, uint_ c2 = 0, uint_ c3 = 0 )
+	{
+		_ctr[0] = 0;
+		_ctr[1] = c1;
+		_ctr[2] = c2;
+		_ctr[3] = c3;
+		_i = 4;
+	}
+
+	HYBRID inline uint_ operator()()
+	{
+		if( _i == 4 )
+		{
+			block( _ctr, _key, _out );
+			_ctr[0]++;
+			_i = 0;
+		}
+
+		return _out[_i++];
+	}
+
+	HYBRID static inline void
+	block( uint_ const ( &ctr )[4], uint_ const ( &key )[2], uint_ ( &out )[4] )
+	{
+		uint_ c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+		uint_ k0 = key[0], k1 = key[1];
+
+		for( int_ round = 0; round < 10; round++ )
+		{
+			ulong_ const p0 = (ulong_)0xD2511F53u * c0;
+			ulong_ const p1 = (ulong_)0xCD9E8D57u * c2;
+
+			c0 = ( uint_ )( p1 >> 32 ) ^ c1 ^ k0;
+			c1 = (uint_)p1;
+			c2 = ( uint_ )( p0 >> 32 ) ^ c3 ^ k1;
+			c3 = (uint_)p0;
+
+			k0 += 0x9E3779B9u;
+			k1 += 0xBB67AE85u;
+		}
+
+		out[0] = c0;
+		out[1] = c1;
+		out[2] = c2;
+		out[3] = c3;
+	}
+
+private:
+	uint_ _key[2];
+	uint_ _ctr[4] = {};
+	uint_ _out[4] = {};
+	int_ _i = 4;
 };
 
 
@@ -0,0 +1,231 @@
+#include <spice/util/spike_recorder.h>
+
+#include <spice/util/assert.h>
+#include <spice/util/type_traits.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+
+static char const MAGIC[4] = { 'S', 'P', 'K', 'R' };
+static uint_ const VERSION = 1;
+// Chunks are handed to the writer thread once they exceed this size
+static size_ const CHUNK_SIZE = 1 << 20;
+// Recording blocks while this many chunks are waiting to be written
+static size_ const MAX_PENDING = 8;
+
+
+static void put_varint( std::vector<char> & out, ulong_ x )
+{
+	while( x >= 0x80 )
+	{
+		out.push_back( static_cast<char>( x | 0x80 ) );
+		x >>= 7;
+	}
+	out.push_back( static_cast<char>( x ) );
+}
+
+
+namespace spice::util
+{
+spike_recorder::spike_recorder(
+    std::string const & path, std::vector<std::pair<size_, size_>> ranges /* = {} */ )
+    : _ranges( std::move( ranges ) )
+{
+	for( size_ i = 0; i < _ranges.size(); i++ )
+		spice_assert(
+		    _ranges[i].first <= _ranges[i].second &&
+		        ( i == 0 || _ranges[i - 1].second <= _ranges[i].first ),
+		    "ranges must be ascending and disjoint" );
+
+	_file = std::fopen( path.c_str(), "wb" );
+	if( !_file ) throw std::runtime_error( "failed to open '" + path + "' for writing" );
+
+	_chunk.insert( _chunk.end(), MAGIC, MAGIC + 4 );
+	for( int_ i = 0; i < 4; i++ ) _chunk.push_back( static_cast<char>( VERSION >> ( 8 * i ) ) );
+
+	_writer = std::thread( [this] { _write(); } );
+}
+
+spike_recorder::~spike_recorder()
+{
+	try
+	{
+		close();
+	}
+	catch( ... )
+	{
+	}
+}
+
+void spike_recorder::operator()( int_ const istep, nonstd::span<int const> spikes )
+{
+	spice_assert( _file, "recorder already closed" );
+	spice_assert( istep > _prev, "steps must be recorded in ascending order" );
+	spice_assert( std::is_sorted( spikes.begin(), spikes.end() ), "spikes must be sorted" );
+
+	if( !_ranges.empty() )
+	{
+		_filtered.clear();
+		for( auto const & [first, last] : _ranges )
+		{
+			auto a = std::lower_bound( spikes.begin(), spikes.end(), narrow<int>( first ) );
+			auto b = std::lower_bound( a, spikes.end(), narrow<int>( last ) );
+			_filtered.insert( _filtered.end(), a, b );
+		}
+		spikes = _filtered;
+	}
+
+	if( spikes.empty() ) return;
+
+	put_varint( _chunk, istep - _prev );
+	put_varint( _chunk, spikes.size() );
+
+	int prev = 0;
+	for( int s : spikes )
+	{
+		put_varint( _chunk, s - prev );
+		prev = s;
+	}
+
+	_prev = istep;
+
+	if( _chunk.size() >= CHUNK_SIZE ) _submit();
+}
+
+void spike_recorder::flush()
+{
+	_submit();
+
+	std::unique_lock l( _lock );
+	_cv.wait( l, [this] { return _queue.empty() && !_busy; } );
+
+	if( _error ) std::rethrow_exception( std::exchange( _error, nullptr ) );
+}
+
+void spike_recorder::close()
+{
+	if( !_file ) return;
+
+	std::exception_ptr error;
+	try
+	{
+		flush();
+	}
+	catch( ... )
+	{
+		error = std::current_exception();
+	}
+
+	{
+		std::lock_guard _( _lock );
+		_running = false;
+	}
+	_cv.notify_all();
+	_writer.join();
+
+	if( std::fclose( std::exchange( _file, nullptr ) ) && !error )
+		error = std::make_exception_ptr( std::runtime_error( "failed to close spike recording" ) );
+
+	if( error ) std::rethrow_exception( error );
+}
+
+void spike_recorder::_submit()
+{
+	std::unique_lock l( _lock );
+
+	if( _error ) std::rethrow_exception( std::exchange( _error, nullptr ) );
+	if( _chunk.empty() ) return;
+
+	// Back pressure: don't outrun the disk by more than MAX_PENDING chunks
+	_cv.wait( l, [this] { return _queue.size() < MAX_PENDING || _error; } );
+	if( _error ) std::rethrow_exception( std::exchange( _error, nullptr ) );
+
+	_queue.push_back( std::move( _chunk ) );
+	_chunk.clear();
+	if( !_spare.empty() )
+	{
+		_chunk = std::move( _spare.back() );
+		_spare.pop_back();
+	}
+	_cv.notify_all();
+}
+
+void spike_recorder::_write()
+{
+	std::unique_lock l( _lock );
+	while( true )
+	{
+		_cv.wait( l, [this] { return !_running || !_queue.empty(); } );
+		if( _queue.empty() ) return;
+
+		auto chunk = std::move( _queue.front() );
+		_queue.erase( _queue.begin() );
+		_busy = true;
+
+		l.unlock();
+		bool const ok = std::fwrite( chunk.data(), 1, chunk.size(), _file ) == chunk.size() &&
+		                !std::fflush( _file );
+		l.lock();
+
+		if( !ok && !_error )
+			_error = std::make_exception_ptr( std::runtime_error( "failed to write spikes" ) );
+
+		chunk.clear();
+		_spare.push_back( std::move( chunk ) );
+		_busy = false;
+		_cv.notify_all();
+	}
+}
+
+
+spike_reader::spike_reader( std::string const & path )
+    : _file( path )
+{
+	char const * data = _file.data();
+
+	uint_ version = 0;
+	for( int_ i = 0; i < 4 && 4 + i < narrow<int_>( _file.size() ); i++ )
+		version |= uint_( static_cast<unsigned char>( data[4 + i] ) ) << ( 8 * i );
+
+	spice_assert(
+	    _file.size() >= 8 && !std::memcmp( data, MAGIC, 4 ) && version == VERSION,
+	    "not a spike recording" );
+
+	rewind();
+}
+
+bool spike_reader::next( int_ & istep, std::vector<int> & spikes )
+{
+	if( _pos == _file.size() ) return false;
+
+	_prev += narrow<int_>( _varint() );
+	istep = _prev;
+
+	spikes.resize( _varint() );
+	int prev = 0;
+	for( int & s : spikes ) s = prev += narrow<int>( _varint() );
+
+	return true;
+}
+
+void spike_reader::rewind()
+{
+	_pos = 8;
+	_prev = -1;
+}
+
+ulong_ spike_reader::_varint()
+{
+	ulong_ result = 0;
+	for( int_ shift = 0;; shift += 7 )
+	{
+		spice_assert( _pos < _file.size() && shift < 64, "truncated spike recording" );
+
+		auto const byte = static_cast<unsigned char>( _file.data()[_pos++] );
+		result |= ulong_( byte & 0x7f ) << shift;
+		if( !( byte & 0x80 ) ) return result;
+	}
+}
+} // namespace spice::util
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <spice/util/mapped_file.h>
+#include <spice/util/span.hpp>
+#include <spice/util/stdint.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace spice
+{
+namespace util
+{
+// File format: "SPKR", version (uint32 LE), followed by one record per step with at least one
+// (recorded) spike: varint( istep - previous istep ), varint( no. of spikes ), varint( 1st id ),
+// varint( 2nd id - 1st id ), ... (unsigned LEB128, previous istep is -1 initially).
+
+// Records spikes to a file. Encoding is cheap and happens on the calling thread, writing happens
+// on a background thread so that the simulation only waits for I/O if the disk falls behind by
+// more than a few chunks.
+class spike_recorder
+{
+public:
+	// Records only the spikes of neurons in 'ranges' ([first, last) each, ascending and disjoint,
+	// e.g. one per population of interest), all spikes if empty.
+	explicit spike_recorder(
+	    std::string const & path, std::vector<std::pair<size_, size_>> ranges = {} );
+	// Closes the file, ignoring errors (call close() to observe them)
+	~spike_recorder();
+
+	spike_recorder( spike_recorder const & ) = delete;
+	spike_recorder & operator=( spike_recorder const & ) = delete;
+
+	// Records the (sorted) spikes emitted during step 'istep'. Steps must be recorded in
+	// ascending order. Matches the signature of cpu::snn::run()'s sink.
+	void operator()( int_ istep, nonstd::span<int const> spikes );
+
+	// Blocks until all steps recorded so far have been written. Rethrows write errors.
+	void flush();
+	// Flushes and closes the file. Rethrows write errors. No more steps may be recorded afterwards.
+	void close();
+
+private:
+	std::vector<std::pair<size_, size_>> const _ranges;
+	int_ _prev = -1;
+	std::vector<int> _filtered;
+
+	// being encoded into by the caller
+	std::vector<char> _chunk;
+
+	std::FILE * _file = nullptr;
+	std::thread _writer;
+	std::mutex _lock;
+	std::condition_variable _cv;
+	// chunks waiting to be written and empty ones to be reused
+	std::vector<std::vector<char>> _queue;
+	std::vector<std::vector<char>> _spare;
+	bool _busy = false;
+	bool _running = true;
+	std::exception_ptr _error;
+
+	void _submit();
+	void _write();
+};
+
+// Reads files written by spike_recorder. Maps them into memory if possible.
+class spike_reader
+{
+public:
+	explicit spike_reader( std::string const & path );
+
+	// Reads the next recorded step into 'istep' and 'spikes'. Steps without spikes are skipped.
+	// @return false at the end of the file
+	bool next( int_ & istep, std::vector<int> & spikes );
+	// Restarts from the first step
+	void rewind();
+
+private:
+	mapped_file _file;
+
+	size_ _pos = 0;
+	int_ _prev = -1;
+
+	ulong_ _varint();
+};
+} // namespace util
+} // namespace spice
@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+
+#include <spice/cpu/snn.h>
+#include <spice/models/brunel.h>
+
+#include <algorithm>
+#include <thread>
+
+using namespace spice;
+
+
+// Receive on large networks is bound by the memory traffic of reading edges. Compares
+// simulating a network via its plain CSR graph (arg 0 = 0) with its compressed copy (1) and with
+// regenerating its edges on demand (2), on a single thread (arg 1 = 0) or all hardware threads
+// (1).
+static int_ const STEPS = 100;
+
+static void cpu_Receive( benchmark::State & state )
+{
+	bool const compress = state.range( 0 ) == 1;
+	bool const procedural = state.range( 0 ) == 2;
+	size_ const N = 200'000;
+	int_ const num_threads =
+	    state.range( 1 ) ? std::max( 1u, std::thread::hardware_concurrency() ) : 1;
+
+	cpu::snn<brunel> net(
+	    { N, 0.005f }, 0.0001f, 1, num_threads, 1337, false, compress, procedural );
+	net.run( 10 );
+
+	for( auto _ : state ) net.run( STEPS );
+
+	state.counters["compress"] = compress;
+	state.counters["procedural"] = procedural;
+	state.counters["num_threads"] = num_threads;
+	state.SetItemsProcessed( state.iterations() * STEPS );
+}
+BENCHMARK( cpu_Receive )
+    ->Unit( benchmark::kMillisecond )
+    ->ArgsProduct( { { 0, 1, 2 }, { 0, 1 } } );
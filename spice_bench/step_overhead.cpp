@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+
+#include <spice_bench/exp_range.h>
+
+#include <spice/cpu/snn.h>
+#include <spice/models/brunel.h>
+
+#include <vector>
+
+using namespace spice;
+
+
+// Per-step overhead for small, latency-bound networks: step() through the base class (one virtual
+// call and one copy of the spikes per step) vs. run() (one tight loop streaming spikes to a sink)
+static int_ const STEPS = 1000;
+
+static void cpu_StepVirtual( benchmark::State & state )
+{
+	size_ const N = state.range( 0 );
+	state.counters["num_neurons"] = static_cast<double>( N );
+
+	cpu::snn<brunel> net( { N, 0.1f }, 0.0001f, 1, 1, 1337 );
+	spice::snn<brunel> & base = net;
+
+	std::vector<int> spikes;
+	for( auto _ : state )
+		for( int_ i = 0; i < STEPS; i++ )
+		{
+			base.step( &spikes );
+			benchmark::DoNotOptimize( spikes.data() );
+		}
+
+	state.SetItemsProcessed( state.iterations() * STEPS );
+}
+BENCHMARK( cpu_StepVirtual )->Unit( benchmark::kMicrosecond )->ExpRange( 16, 4096, 4 );
+
+static void cpu_Run( benchmark::State & state )
+{
+	size_ const N = state.range( 0 );
+	state.counters["num_neurons"] = static_cast<double>( N );
+
+	cpu::snn<brunel> net( { N, 0.1f }, 0.0001f, 1, 1, 1337 );
+
+	size_ nspikes = 0;
+	for( auto _ : state )
+		net.run( STEPS, [&]( int_, nonstd::span<int const> spikes ) { nspikes += spikes.size(); } );
+
+	benchmark::DoNotOptimize( nspikes );
+	state.SetItemsProcessed( state.iterations() * STEPS );
+}
+BENCHMARK( cpu_Run )->Unit( benchmark::kMicrosecond )->ExpRange( 16, 4096, 4 );
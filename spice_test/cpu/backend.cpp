@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include <spice/cpu/backend.h>
+#include <spice/cpu/util/thread_pool.h>
+
+
+using namespace spice;
+
+
+TEST( Backend, Seek )
+{
+	backend x( 1337 );
+	backend y( 1337 );
+
+	x.seek( backend::neuron_update, 5, 7 );
+	float const a = x.rand();
+	x.rand();
+
+	y.seek( backend::neuron_update, 6, 7 );
+	ASSERT_NE( y.rand(), a );
+
+	y.seek( backend::neuron_update, 5, 7 );
+	ASSERT_EQ( y.rand(), a );
+}
+
+TEST( Backend, AtomicAdd )
+{
+	cpu::util::thread_pool pool( 4 );
+
+	int_ i = 0;
+	float f = 0.0f;
+	pool.run( [&]( int_ ) {
+		for( int_ k = 0; k < 10000; k++ )
+		{
+			atomic_backend::atomic_add( i, 1 );
+			atomic_backend::atomic_add( f, 0.5f );
+		}
+	} );
+
+	ASSERT_EQ( i, 40000 );
+	ASSERT_EQ( f, 20000.0f );
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <spice/cpu/ensemble.h>
+#include <spice/cpu/snn.h>
+#include <spice/models/brunel.h>
+#include <spice/models/vogels_abbott.h>
+
+#include <algorithm>
+
+
+using namespace spice;
+
+
+// Models without synapse state
+using StaticModels = ::testing::Types<vogels_abbott, brunel>;
+
+template <typename T>
+struct Ensemble : ::testing::Test
+{
+};
+TYPED_TEST_CASE( Ensemble, StaticModels );
+
+TYPED_TEST( Ensemble, Ctor )
+{
+	cpu::ensemble<TypeParam> x( { 1000, 0.1f }, 0.0001f, 15, { 1, 2, 3 } );
+
+	ASSERT_EQ( x.size(), 3u );
+	ASSERT_EQ( x.num_neurons(), 1000u );
+	ASSERT_EQ( x.dt(), 0.0001f );
+	ASSERT_EQ( x.delay(), 15 );
+
+	auto const [edges, width] = x.adj();
+	ASSERT_EQ( edges.size() % width, 0u );
+	ASSERT_EQ( width % 32, 0u );
+	// num_synapses() excludes the padding
+	size_ const num_edges = edges.size() - std::count( edges.begin(), edges.end(), -1 );
+	ASSERT_EQ( num_edges, x.num_synapses() );
+
+	for( size_ k = 0; k < x.size(); k++ ) ASSERT_EQ( x.neurons( k ).size(), 1000u );
+
+	ASSERT_THROW( ( cpu::ensemble<TypeParam>( { 1000, 0.1f }, 0.0001f, 15, {} ) ),
+	              std::invalid_argument );
+}
+
+TYPED_TEST( Ensemble, Step )
+{
+	// Instances seeded like cpu::snn behave exactly like it. Results don't depend on the no. of
+	// threads.
+	cpu::snn<TypeParam> x( { 1000, 0.1f }, 0.0001f, 15, 1, 1337 );
+	cpu::ensemble<TypeParam> y( { 1000, 0.1f }, 0.0001f, 15, { 1337, 42, 1337 }, 1 );
+	cpu::ensemble<TypeParam> z( { 1000, 0.1f }, 0.0001f, 15, { 1337, 42, 1337 }, 3 );
+
+	ASSERT_EQ( x.adj(), y.adj() );
+
+	std::vector<int> xs;
+	std::vector<std::vector<int>> ys, zs;
+	for( int_ i = 0; i < 500; i++ )
+	{
+		x.step( &xs );
+		y.step( &ys );
+		z.step( &zs );
+
+		ASSERT_EQ( ys.size(), 3u );
+		ASSERT_EQ( xs, ys[0] );
+		ASSERT_EQ( xs, ys[2] );
+		ASSERT_EQ( ys, zs );
+	}
+
+	ASSERT_EQ( x.neurons(), y.neurons( 0 ) );
+	ASSERT_EQ( x.neurons(), y.neurons( 2 ) );
+}
+
+TEST( Ensemble, Wide )
+{
+	// More than 64 instances (spike masks span several words)
+	std::vector<ulong_> seeds( 70 );
+	for( size_ k = 0; k < seeds.size(); k++ ) seeds[k] = k + 1;
+	seeds[0] = seeds[65] = 1337;
+
+	cpu::snn<brunel> x( { 1000, 0.1f }, 0.0001f, 15, 1, 1337 );
+	cpu::ensemble<brunel> y( { 1000, 0.1f }, 0.0001f, 15, seeds, 2 );
+
+	std::vector<int> xs;
+	std::vector<std::vector<int>> ys;
+	bool differ = false;
+	for( int_ i = 0; i < 100; i++ )
+	{
+		x.step( &xs );
+		y.step( &ys );
+
+		ASSERT_EQ( xs, ys[0] );
+		ASSERT_EQ( xs, ys[65] );
+
+		// brunel's poisson neurons depend on the seed
+		differ |= ys[1] != xs;
+	}
+
+	ASSERT_TRUE( differ );
+}
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include "../model.h"
+
+#include <spice/cpu/multi_snn.h>
+#include <spice/cpu/snn.h>
+
+#include <algorithm>
+
+
+using namespace spice;
+
+
+TEST_CPU_MODELS( MultiSNN );
+
+TYPED_TEST( MultiSNN, Ctor )
+{
+	{
+		cpu::multi_snn<TypeParam> x( { 1000, 0.1f }, 0.0001f, 15, 3 );
+
+		ASSERT_EQ( x.num_neurons(), 1000u );
+		ASSERT_EQ( x.dt(), 0.0001f );
+		ASSERT_EQ( x.delay(), 15 );
+
+		ASSERT_EQ( x.neurons().size(), 1000u );
+
+		auto const [edges, width] = x.adj();
+		ASSERT_EQ( edges.size(), 1000 * width );
+		ASSERT_EQ( width % 32, 0u );
+
+		util::adj_list adj( 1000, width, edges.data() );
+		size_ num_edges = 0;
+		for( size_ i = 0; i < 1000; i++ )
+		{
+			auto const row = adj.neighbors( i );
+			num_edges += row.size();
+			ASSERT_TRUE( std::is_sorted( row.begin(), row.end() ) );
+			for( int_ dst : row ) ASSERT_TRUE( dst >= 0 && dst < 1000 );
+		}
+		// num_synapses() excludes the padding
+		ASSERT_EQ( num_edges, x.num_synapses() );
+
+		if constexpr( TypeParam::synapse::size > 0 )
+		{
+			ASSERT_EQ( x.synapses().size(), edges.size() );
+		}
+	}
+
+	{
+		// more partitions than slices of 64 neurons
+		cpu::multi_snn<TypeParam> x( { 100, 0.1f }, 0.0001f, 15, 4 );
+		ASSERT_EQ( x.neurons().size(), 100u );
+
+		std::vector<int> spikes;
+		x.step( &spikes );
+	}
+}
+
+TYPED_TEST( MultiSNN, Step )
+{
+	// A single partition is identical to cpu::snn
+	{
+		cpu::snn<TypeParam> x( { 1000, 0.1f }, 0.0001f, 15, 1, 1337 );
+		cpu::multi_snn<TypeParam> y( { 1000, 0.1f }, 0.0001f, 15, 1, 1, 1337 );
+
+		ASSERT_EQ( x.adj(), y.adj() );
+
+		std::vector<int> xs, tmp, ys;
+		for( int_ i = 0; i < 10; i++ )
+		{
+			xs.clear();
+			for( int_ j = 0; j < 15; j++ )
+			{
+				x.step( &tmp );
+				xs.insert( xs.end(), tmp.begin(), tmp.end() );
+			}
+			y.step( &ys );
+
+			ASSERT_EQ( xs, ys );
+		}
+
+		ASSERT_EQ( x.neurons(), y.neurons() );
+		ASSERT_EQ( x.synapses(), y.synapses() );
+	}
+
+	// Results don't depend on the no. of threads per partition
+	{
+		cpu::multi_snn<TypeParam> x( { 1000, 0.1f }, 0.0001f, 15, 3, 1, 1337 );
+		cpu::multi_snn<TypeParam> y( { 1000, 0.1f }, 0.0001f, 15, 3, 2, 1337 );
+
+		ASSERT_EQ( x.adj(), y.adj() );
+
+		std::vector<int> xs, ys;
+		for( int_ i = 0; i < 10; i++ )
+		{
+			x.step( &xs );
+			y.step( &ys );
+
+			ASSERT_EQ( xs, ys );
+			for( int_ s : xs ) ASSERT_TRUE( s >= 0 && s < 1000 );
+		}
+
+		ASSERT_EQ( x.neurons(), y.neurons() );
+		ASSERT_EQ( x.synapses(), y.synapses() );
+	}
+
+	// NUMA placement doesn't affect results either
+	{
+		cpu::multi_snn<TypeParam> x( { 1000, 0.1f }, 0.0001f, 15, 2, 2, 1337 );
+		cpu::multi_snn<TypeParam> y( { 1000, 0.1f }, 0.0001f, 15, 2, 2, 1337, true );
+
+		ASSERT_EQ( x.adj(), y.adj() );
+
+		std::vector<int> xs, ys;
+		for( int_ i = 0; i < 10; i++ )
+		{
+			x.step( &xs );
+			y.step( &ys );
+
+			ASSERT_EQ( xs, ys );
+		}
+
+		ASSERT_EQ( x.neurons(), y.neurons() );
+		ASSERT_EQ( x.synapses(), y.synapses() );
+	}
+}
+
+TYPED_TEST( MultiSNN, Delays )
+{
+	// Partitions exchange spikes every (smallest) delay steps, spikes along connections with
+	// longer delays are delivered later from their own history.
+	if constexpr( TypeParam::synapse::size == 0 )
+	{
+		util::layout const desc(
+		    { 500, 500 }, { { 0, 0, 0.1f, 0 }, { 0, 1, 0.1f, 20 }, { 1, 0, 0.1f, 25 } } );
+
+		// A single partition is identical to cpu::snn
+		{
+			cpu::snn<TypeParam> x( desc, 0.005f, 15, 1, 1337 );
+			cpu::multi_snn<TypeParam> y( desc, 0.005f, 15, 1, 1, 1337 );
+
+			ASSERT_EQ( y.delay(), 15 );
+			ASSERT_EQ( x.adj(), y.adj() );
+
+			std::vector<int> xs, tmp, ys;
+			for( int_ i = 0; i < 10; i++ )
+			{
+				xs.clear();
+				for( int_ j = 0; j < 15; j++ )
+				{
+					x.step( &tmp );
+					xs.insert( xs.end(), tmp.begin(), tmp.end() );
+				}
+				y.step( &ys );
+
+				ASSERT_EQ( xs, ys );
+			}
+
+			ASSERT_EQ( x.neurons(), y.neurons() );
+		}
+
+		// Results don't depend on the no. of threads per partition
+		{
+			cpu::multi_snn<TypeParam> x( desc, 0.005f, 15, 3, 1, 1337 );
+			cpu::multi_snn<TypeParam> y( desc, 0.005f, 15, 3, 2, 1337 );
+
+			std::vector<int> xs, ys;
+			for( int_ i = 0; i < 10; i++ )
+			{
+				x.step( &xs );
+				y.step( &ys );
+
+				ASSERT_EQ( xs, ys );
+			}
+
+			ASSERT_EQ( x.neurons(), y.neurons() );
+		}
+	}
+}
+
+TYPED_TEST( MultiSNN, Run )
+{
+	cpu::multi_snn<TypeParam> x( { 1000, 0.1f }, 0.0001f, 15, 3, 1, 1337 );
+	cpu::multi_snn<TypeParam> y( { 1000, 0.1f }, 0.0001f, 15, 3, 1, 1337 );
+
+	std::vector<int> xs, ys;
+	for( int_ i = 0; i < 10; i++ )
+	{
+		x.step( &xs );
+
+		ys.clear();
+		int_ j = 0;
+		y.run( 15, [&]( int_ const istep, nonstd::span<int const> spikes ) {
+			ASSERT_EQ( istep, i * 15 + j++ );
+			ys.insert( ys.end(), spikes.begin(), spikes.end() );
+		} );
+
+		ASSERT_EQ( xs, ys );
+	}
+
+	ASSERT_THROW( y.run( 7 ), std::invalid_argument );
+}
+
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <spice/cpu/util/hbuffer.h>
+
+#include <memory>
+#include <stdexcept>
+
+
+using namespace spice::cpu::util;
+
+
+static auto vec( std::initializer_list<int> l ) { return std::vector<int>( l ); }
+
+TEST( HBuffer, DefaultCtor )
+{
+	hbuffer<int> x;
+
+	ASSERT_EQ( x.data(), nullptr );
+	ASSERT_EQ( x.size(), 0u );
+	ASSERT_EQ( x.size_in_bytes(), 0u );
+}
+
+TEST( HBuffer, SizeCtor )
+{
+	hbuffer<int> x( 23 );
+
+	ASSERT_NE( x.data(), nullptr );
+	ASSERT_EQ( x.size(), 23u );
+	ASSERT_EQ( x.size_in_bytes(), 23 * sizeof( int_ ) );
+	ASSERT_EQ( reinterpret_cast<std::uintptr_t>( x.data() ) % hbuffer<int>::alignment, 0u );
+
+	for( int_ i : x ) ASSERT_EQ( i, 0 );
+}
+
+TEST( HBuffer, Copy )
+{
+	auto y = vec( { 1, 2, 3, 4, 5 } );
+	hbuffer<int> z( y );
+	hbuffer<int> x( z );
+	y.clear();
+	y = x;
+
+	ASSERT_NE( x.data(), z.data() );
+	ASSERT_EQ( y, vec( { 1, 2, 3, 4, 5 } ) );
+
+	x = vec( { 6, 7 } );
+	ASSERT_EQ( std::vector<int>( x ), vec( { 6, 7 } ) );
+}
+
+TEST( HBuffer, Move )
+{
+	hbuffer<int> y( vec( { 1, 2, 3 } ) );
+	auto const * p = y.data();
+
+	hbuffer<int> x( std::move( y ) );
+	ASSERT_EQ( x.data(), p );
+	ASSERT_EQ( x.size(), 3u );
+	ASSERT_EQ( y.size(), 0u );
+}
+
+TEST( HBuffer, Resize )
+{
+	hbuffer<int> x( vec( { 1, 2, 3 } ) );
+
+	x.resize( 2 );
+	ASSERT_EQ( std::vector<int>( x ), vec( { 1, 2 } ) );
+
+	x.resize( 100 );
+	ASSERT_EQ( x.size(), 100u );
+	ASSERT_EQ( x[0], 1 );
+	ASSERT_EQ( x[1], 2 );
+	for( size_ i = 2; i < x.size(); i++ ) ASSERT_EQ( x[i], 0 );
+	ASSERT_EQ( reinterpret_cast<std::uintptr_t>( x.data() ) % hbuffer<int>::alignment, 0u );
+}
+
+TEST( HBuffer, Adopt )
+{
+	alignas( 64 ) static int data[4] = { 1, 2, 3, 4 };
+	auto owner = std::make_shared<int>( 0 );
+
+	{
+		hbuffer<int> x( data, 4, owner );
+		ASSERT_EQ( x.data(), data );
+		ASSERT_EQ( std::vector<int>( x ), vec( { 1, 2, 3, 4 } ) );
+		ASSERT_EQ( owner.use_count(), 2 );
+
+		// Growing moves the data into memory of its own
+		x.resize( 8 );
+		ASSERT_NE( x.data(), data );
+		ASSERT_EQ( std::vector<int>( x ), vec( { 1, 2, 3, 4, 0, 0, 0, 0 } ) );
+		ASSERT_EQ( owner.use_count(), 1 );
+	}
+
+	ASSERT_THROW( hbuffer<int>( data + 1, 3, owner ), std::invalid_argument );
+}
+
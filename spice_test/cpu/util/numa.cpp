@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <spice/cpu/util/numa.h>
+
+#include <algorithm>
+#include <thread>
+
+
+using namespace spice::cpu::util;
+
+
+TEST( NUMA, Topology )
+{
+	auto const nodes = numa_nodes();
+	ASSERT_FALSE( nodes.empty() );
+	ASSERT_TRUE( std::is_sorted( nodes.begin(), nodes.end() ) );
+
+#ifdef __linux__
+	auto const all = thread_affinity();
+	ASSERT_FALSE( all.empty() );
+
+	// Every CPU we may run on belongs to some node
+	for( int cpu : all )
+		ASSERT_TRUE( std::any_of( nodes.begin(), nodes.end(), [&]( int node ) {
+			auto const cpus = numa_cpus( node );
+			return std::find( cpus.begin(), cpus.end(), cpu ) != cpus.end();
+		} ) );
+#endif
+}
+
+TEST( NUMA, Affinity )
+{
+	ASSERT_FALSE( set_thread_affinity( {} ) );
+
+#ifdef __linux__
+	// Pin a separate thread so as not to affect the others
+	std::thread( [] {
+		auto const all = thread_affinity();
+		ASSERT_TRUE( set_thread_affinity( { all.back() } ) );
+		ASSERT_EQ( thread_affinity(), std::vector<int>{ all.back() } );
+
+		// Inherited by spawned threads
+		std::thread( [&] { ASSERT_EQ( thread_affinity(), std::vector<int>{ all.back() } ); } )
+		    .join();
+
+		ASSERT_TRUE( set_thread_affinity( all ) );
+		ASSERT_EQ( thread_affinity(), all );
+	} ).join();
+#endif
+}
+
+TEST( NUMA, AllocStats )
+{
+	ASSERT_EQ( numa_alloc_stats().other_ratio(), 0.0 );
+	ASSERT_EQ( ( numa_alloc_stats{ 3, 1 }.other_ratio() ), 0.25 );
+
+	auto const x = numa_alloc_stats::read();
+	auto const y = numa_alloc_stats::read();
+	auto const d = y - x;
+	ASSERT_GE( d.other_ratio(), 0.0 );
+	ASSERT_LE( d.other_ratio(), 1.0 );
+}
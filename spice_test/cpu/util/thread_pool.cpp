@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <spice/cpu/util/thread_pool.h>
+
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+
+
+using namespace spice::cpu::util;
+
+
+TEST( ThreadPool, Ctor )
+{
+	{
+		thread_pool x;
+		ASSERT_EQ( x.size(), 1 );
+	}
+
+	{
+		thread_pool x( 4 );
+		ASSERT_EQ( x.size(), 4 );
+	}
+
+	ASSERT_THROW( thread_pool( 0 ), std::invalid_argument );
+}
+
+TEST( ThreadPool, Chunk )
+{
+	ASSERT_EQ( thread_pool::chunk( 10, 1, 0 ), std::make_pair( 0_sz, 10_sz ) );
+
+	ASSERT_EQ( thread_pool::chunk( 10, 2, 0 ), std::make_pair( 0_sz, 5_sz ) );
+	ASSERT_EQ( thread_pool::chunk( 10, 2, 1 ), std::make_pair( 5_sz, 10_sz ) );
+
+	ASSERT_EQ( thread_pool::chunk( 100, 2, 0, 64 ), std::make_pair( 0_sz, 64_sz ) );
+	ASSERT_EQ( thread_pool::chunk( 100, 2, 1, 64 ), std::make_pair( 64_sz, 100_sz ) );
+
+	ASSERT_EQ( thread_pool::chunk( 10, 3, 0, 64 ), std::make_pair( 0_sz, 0_sz ) );
+	ASSERT_EQ( thread_pool::chunk( 10, 3, 1, 64 ), std::make_pair( 0_sz, 0_sz ) );
+	ASSERT_EQ( thread_pool::chunk( 10, 3, 2, 64 ), std::make_pair( 0_sz, 10_sz ) );
+
+	for( int_ n = 1; n < 8; n++ )
+	{
+		size_ prev = 0;
+		for( int_ i = 0; i < n; i++ )
+		{
+			auto const [first, last] = thread_pool::chunk( 1000, n, i, 32 );
+			ASSERT_EQ( first, prev );
+			ASSERT_LE( first, last );
+			ASSERT_EQ( first % 32, 0u );
+			prev = last;
+		}
+		ASSERT_EQ( prev, 1000u );
+	}
+}
+
+TEST( ThreadPool, Run )
+{
+	for( int_ n : { 1, 2, 5 } )
+	{
+		thread_pool x( n );
+
+		for( int_ k = 0; k < 100; k++ )
+		{
+			std::vector<int> hits( n );
+			x.run( [&]( int_ i ) { hits[i]++; } );
+
+			for( int_ h : hits ) ASSERT_EQ( h, 1 );
+		}
+
+		// Jobs are passed by reference, neither copied nor required to be copyable
+		std::atomic<int> calls{ 0 };
+		auto job = [p = std::make_unique<std::atomic<int> *>( &calls )]( int_ ) mutable {
+			( **p )++;
+		};
+		x.run( job );
+		ASSERT_EQ( calls, n );
+	}
+}
+
+TEST( ThreadPool, ParallelFor )
+{
+	thread_pool x( 3 );
+
+	std::vector<int> v( 1000 );
+	x.parallel_for( v.size(), [&]( size_ first, size_ last, int_ ) {
+		for( size_ i = first; i < last; i++ ) v[i] += static_cast<int>( i );
+	} );
+
+	std::vector<int> expected( 1000 );
+	std::iota( expected.begin(), expected.end(), 0 );
+	ASSERT_EQ( v, expected );
+}
+
+TEST( ThreadPool, Exception )
+{
+	thread_pool x( 3 );
+
+	ASSERT_THROW(
+	    x.run( []( int_ i ) {
+		    if( i == 2 ) throw std::runtime_error( "" );
+	    } ),
+	    std::runtime_error );
+
+	// pool remains usable
+	std::atomic_int32_t count{ 0 };
+	x.run( [&]( int_ ) { count++; } );
+	ASSERT_EQ( count, 3 );
+}
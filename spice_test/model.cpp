@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <spice/models/brunel.h>
+#include <spice/models/model.h>
+#include <spice/models/synth.h>
+#include <spice/models/vogels_abbott.h>
+
+#include <tuple>
+#include <vector>
+
+
+using namespace spice;
+
+
+TEST( Model, WithPopulation )
+{
+	snn_info info{ 100 };
+	set_populations<brunel::neuron>( info );
+
+	// [0, 50) Poisson, [50, 90) excitatory, [90, 100) inhibitory
+	for( int_ i = 0; i < info.num_neurons; i++ )
+	{
+		int_ p = -1;
+		with_population<brunel::neuron>( i, info, [&]( auto P ) { p = decltype( P )::value; } );
+		ASSERT_EQ( p, i < 50 ? 0 : i < 90 ? 1 : 2 );
+	}
+
+	// Models without populations have a single one
+	int_ p = -1;
+	with_population<synth::neuron>( 99, info, [&]( auto P ) { p = decltype( P )::value; } );
+	ASSERT_EQ( p, 0 );
+}
+
+TEST( Model, ForEachPopulation )
+{
+	snn_info info{ 100 };
+	set_populations<brunel::neuron>( info );
+
+	std::vector<std::tuple<int_, int_, int_>> pieces;
+	auto const f = [&]( auto P, int_ a, int_ b ) {
+		pieces.emplace_back( decltype( P )::value, a, b );
+	};
+
+	for_each_population<brunel::neuron>( 0, 100, info, f );
+	ASSERT_EQ(
+	    pieces,
+	    ( std::vector<std::tuple<int_, int_, int_>>{
+	        { 0, 0, 50 }, { 1, 50, 90 }, { 2, 90, 100 } } ) );
+
+	// Empty pieces are skipped
+	pieces.clear();
+	for_each_population<brunel::neuron>( 60, 95, info, f );
+	ASSERT_EQ(
+	    pieces, ( std::vector<std::tuple<int_, int_, int_>>{ { 1, 60, 90 }, { 2, 90, 95 } } ) );
+
+	pieces.clear();
+	for_each_population<brunel::neuron>( 7, 7, info, f );
+	ASSERT_TRUE( pieces.empty() );
+
+	pieces.clear();
+	for_each_population<synth::neuron>( 3, 42, info, f );
+	ASSERT_EQ( pieces, ( std::vector<std::tuple<int_, int_, int_>>{ { 0, 3, 42 } } ) );
+
+	// Sorted ids (e.g. spikes), split by index
+	std::vector<int> const spikes{ 3, 49, 50, 51, 89, 99 };
+	pieces.clear();
+	for_each_population<brunel::neuron>(
+	    0, int_( spikes.size() ), info, f, [&]( int_ s ) { return spikes[s]; } );
+	ASSERT_EQ(
+	    pieces,
+	    ( std::vector<std::tuple<int_, int_, int_>>{ { 0, 0, 2 }, { 1, 2, 5 }, { 2, 5, 6 } } ) );
+}
+
+TEST( Model, Populations )
+{
+	snn_info info{ 1000 };
+
+	set_populations<vogels_abbott::neuron>( info );
+	ASSERT_EQ( info.populations[0], 0 );
+	ASSERT_EQ( info.populations[1], 800 );
+	ASSERT_EQ( info.populations[2], 1000 );
+
+	// Models without populations have a single one
+	set_populations<synth::neuron>( info );
+	ASSERT_EQ( info.populations[0], 0 );
+	ASSERT_EQ( info.populations[1], 1000 );
+}
+
+TEST( Model, Constants )
+{
+	snn_info const info{ 1000 };
+
+	auto const x = make_info<vogels_abbott>( info );
+	ASSERT_EQ( x.num_neurons, 1000 );
+	ASSERT_FLOAT_EQ( x.constants.Wex, 0.4f * 16 );
+	ASSERT_FLOAT_EQ( x.constants.Win, 5.1f * 16 );
+}
@@ -1,11 +1,18 @@
 #pragma once
 
 #include <spice/models/brunel.h>
+#include <spice/models/brunel_with_inputs.h>
 #include <spice/models/brunel_with_plasticity.h>
 #include <spice/models/vogels_abbott.h>
 
 
 using Models = ::testing::Types<spice::vogels_abbott, spice::brunel, spice::brunel_with_plasticity>;
+// incl. models only supported by the CPU backends
+using CPUModels = ::testing::Types<
+    spice::vogels_abbott,
+    spice::brunel,
+    spice::brunel_with_plasticity,
+    spice::brunel_with_inputs>;
 
 #define TEST_ALL_MODELS( X )   \
 	template <typename T>      \
@@ -13,3 +20,10 @@ using Models = ::testing::Types<spice::vogels_abbott, spice::brunel, spice::brun
 	{                          \
 	};                         \
 	TYPED_TEST_CASE( X, Models );
+
+#define TEST_CPU_MODELS( X )   \
+	template <typename T>      \
+	struct X : ::testing::Test \
+	{                          \
+	};                         \
+	TYPED_TEST_CASE( X, CPUModels );
@@ -3,6 +3,11 @@
 #include "model.h"
 
 #include <spice/cpu/snn.h>
+#include <spice/models/synth.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
 
 
 using namespace spice;
@@ -14,7 +19,7 @@ float const DT = 0.0001f;
 int_ const DELAY = 15;
 
 
-TEST_ALL_MODELS( SNN );
+TEST_CPU_MODELS( SNN );
 
 TYPED_TEST( SNN, Ctor )
 {
@@ -33,4 +38,431 @@ TYPED_TEST( SNN, Ctor )
 		ASSERT_EQ( x.dt(), DT );
 		ASSERT_EQ( x.delay(), DELAY );
 	}
-}
\ No newline at end of file
+
+	{
+		cpu::snn<TypeParam> x( { N, P }, DT, DELAY, 4 );
+
+		ASSERT_EQ( x.num_neurons(), N );
+		ASSERT_EQ( x.dt(), DT );
+		ASSERT_EQ( x.delay(), DELAY );
+	}
+}
+
+TYPED_TEST( SNN, Info )
+{
+	cpu::snn<TypeParam> x( { N, P }, DT, DELAY );
+	auto const info = x.info();
+
+	ASSERT_EQ( info.num_neurons, N );
+	ASSERT_EQ( info.num_synapses, x.num_synapses() );
+	ASSERT_EQ( info.delay, DELAY );
+	ASSERT_EQ( info.dt, DT );
+
+	// Populations are ascending and span all neurons
+	int_ const n = std::max( TypeParam::neuron::num_populations, 1 );
+	ASSERT_EQ( info.populations[0], 0 );
+	ASSERT_EQ( info.populations[n], N );
+	for( int_ p = 0; p < n; p++ ) ASSERT_LE( info.populations[p], info.populations[p + 1] );
+}
+
+TYPED_TEST( SNN, StepMultiThreaded )
+{
+	cpu::snn<TypeParam> x( { N, P }, DT, DELAY, 4 );
+
+	std::vector<int> spikes;
+	for( int_ i = 0; i < 100; i++ )
+	{
+		x.step( &spikes );
+
+		ASSERT_TRUE( std::is_sorted( spikes.begin(), spikes.end() ) );
+		for( int_ s : spikes ) ASSERT_LT( s, static_cast<int_>( N ) );
+	}
+}
+TYPED_TEST( SNN, StepDeterministic )
+{
+	cpu::snn<TypeParam> x( { N, P }, DT, DELAY, 1, 1337 );
+	cpu::snn<TypeParam> y( { N, P }, DT, DELAY, 3, 1337 );
+
+	ASSERT_EQ( x.adj(), y.adj() );
+
+	std::vector<int> xs, ys;
+	for( int_ i = 0; i < 100; i++ )
+	{
+		x.step( &xs );
+		y.step( &ys );
+
+		ASSERT_EQ( xs, ys );
+	}
+
+	ASSERT_EQ( x.neurons(), y.neurons() );
+	ASSERT_EQ( x.synapses(), y.synapses() );
+}
+
+TEST( SNN, StepScatter )
+{
+	// synth's integer state allows spikes to be delivered in any order (using atomics)
+	cpu::snn<synth> x( { N, P }, DT, DELAY, 1, 1337 );
+	cpu::snn<synth> y( { N, P }, DT, DELAY, 3, 1337 );
+
+	std::vector<int> xs, ys;
+	for( int_ i = 0; i < 100; i++ )
+	{
+		x.step( &xs );
+		y.step( &ys );
+
+		ASSERT_EQ( xs, ys );
+	}
+
+	ASSERT_EQ( x.neurons(), y.neurons() );
+}
+
+TYPED_TEST( SNN, StepPull )
+{
+	// Pulling spikes (dense activity) must not affect results. A large time step causes
+	// (brunel's) activity to alternate between sparse and dense.
+	cpu::snn<TypeParam> x( { N, P }, 50 * DT, DELAY, 1, 1337 );
+	cpu::snn<TypeParam> y( { N, P }, 50 * DT, DELAY, 3, 1337, true );
+
+	std::vector<int> xs, ys;
+	for( int_ i = 0; i < 100; i++ )
+	{
+		x.step( &xs );
+		y.step( &ys );
+
+		ASSERT_EQ( xs, ys );
+	}
+
+	ASSERT_EQ( x.neurons(), y.neurons() );
+	ASSERT_EQ( x.synapses(), y.synapses() );
+}
+
+TYPED_TEST( SNN, StepCompressed )
+{
+	// Receiving via the compressed graph must not affect results, neither when pushing spikes
+	// to a thread's own range (1 thread, brunel) nor when scattering them (3 threads, synth)
+	cpu::snn<TypeParam> x( { N, P }, DT, DELAY, 1, 1337 );
+	cpu::snn<TypeParam> y( { N, P }, DT, DELAY, 1, 1337, false, true );
+	cpu::snn<TypeParam> z( { N, P }, DT, DELAY, 3, 1337, false, true );
+
+	std::vector<int> xs, ys, zs;
+	for( int_ i = 0; i < 100; i++ )
+	{
+		x.step( &xs );
+		y.step( &ys );
+		z.step( &zs );
+
+		ASSERT_EQ( xs, ys );
+		ASSERT_EQ( xs, zs );
+	}
+
+	ASSERT_EQ( x.neurons(), y.neurons() );
+	ASSERT_EQ( x.synapses(), y.synapses() );
+	ASSERT_EQ( x.neurons(), z.neurons() );
+	ASSERT_EQ( x.synapses(), z.synapses() );
+}
+
+TYPED_TEST( SNN, StepProcedural )
+{
+	if constexpr( TypeParam::synapse::size == 0 )
+	{
+		// Regenerating edges on demand must not affect results, neither when pushing spikes to
+		// a thread's own range (1 thread), when bucketing them by destination thread (3
+		// threads) nor when scattering them (3 threads, synth)
+		std::string const path = ::testing::TempDir() + "spice_checkpoint.bin";
+
+		cpu::snn<TypeParam> x( { N, P }, DT, DELAY, 1, 1337 );
+		cpu::snn<TypeParam> y( { N, P }, DT, DELAY, 1, 1337, false, false, true );
+		cpu::snn<TypeParam> z( { N, P }, DT, DELAY, 3, 1337, false, false, true );
+
+		ASSERT_EQ( x.num_synapses(), y.num_synapses() );
+		ASSERT_EQ( x.adj(), y.adj() );
+
+		std::vector<int> xs, ys, zs;
+		for( int_ i = 0; i < 100; i++ )
+		{
+			x.step( &xs );
+			y.step( &ys );
+			z.step( &zs );
+
+			ASSERT_EQ( xs, ys );
+			ASSERT_EQ( xs, zs );
+		}
+
+		ASSERT_EQ( x.neurons(), y.neurons() );
+		ASSERT_EQ( x.neurons(), z.neurons() );
+
+		// Checkpoints store the (regenerated) graph
+		y.save( path );
+		cpu::snn<TypeParam> w( path );
+		ASSERT_EQ( x.adj(), w.adj() );
+
+		std::remove( path.c_str() );
+	}
+	else
+		ASSERT_THROW(
+		    ( cpu::snn<TypeParam>( { N, P }, DT, DELAY, 1, 1337, false, false, true ) ),
+		    std::invalid_argument );
+}
+
+TYPED_TEST( SNN, Delays )
+{
+	using layout = util::layout;
+
+	// Explicit delays equal to the network's don't affect results
+	{
+		cpu::snn<TypeParam> x( { N, P }, DT, DELAY, 1, 1337 );
+		cpu::snn<TypeParam> y( layout( { N }, { { 0, 0, P, DELAY } } ), DT, 1, 1, 1337 );
+
+		ASSERT_EQ( y.delay(), DELAY );
+
+		std::vector<int> xs, ys;
+		for( int_ i = 0; i < 100; i++ )
+		{
+			x.step( &xs );
+			y.step( &ys );
+
+			ASSERT_EQ( xs, ys );
+		}
+		ASSERT_EQ( x.neurons(), y.neurons() );
+	}
+
+	if constexpr( TypeParam::synapse::size == 0 )
+	{
+		// Delivering spikes by delay class (an empty one in this case) doesn't affect results
+		{
+			layout const a( { N / 2, N / 2 }, { { 0, 0, P }, { 0, 1, 0.0f }, { 1, 1, P } } );
+			layout const b(
+			    { N / 2, N / 2 },
+			    { { 0, 0, P, DELAY }, { 0, 1, 0.0f, DELAY + 5 }, { 1, 1, P, 0 } } );
+
+			cpu::snn<TypeParam> x( a, DT, DELAY, 1, 1337 );
+			cpu::snn<TypeParam> y( b, DT, DELAY, 1, 1337 );
+			cpu::snn<TypeParam> z( b, DT, DELAY, 3, 1337 );
+
+			ASSERT_EQ( x.adj(), y.adj() );
+
+			std::vector<int> xs, ys, zs;
+			for( int_ i = 0; i < 100; i++ )
+			{
+				x.step( &xs );
+				y.step( &ys );
+				z.step( &zs );
+
+				ASSERT_EQ( xs, ys );
+				ASSERT_EQ( xs, zs );
+			}
+			ASSERT_EQ( x.neurons(), y.neurons() );
+			ASSERT_EQ( x.neurons(), z.neurons() );
+		}
+
+		// Heterogeneous delays: results depend neither on the no. of threads nor on
+		// checkpointing
+		{
+			std::string const path = ::testing::TempDir() + "spice_checkpoint.bin";
+
+			layout const desc(
+			    { N / 2, N / 2 },
+			    { { 0, 0, P, 0 },
+			      { 0, 1, P, DELAY + 5 },
+			      { 1, 0, P, 2 * DELAY },
+			      { 1, 1, P, 0 } } );
+
+			cpu::snn<TypeParam> x( desc, 50 * DT, DELAY, 1, 1337 );
+			cpu::snn<TypeParam> y( desc, 50 * DT, DELAY, 3, 1337 );
+			ASSERT_EQ( x.delay(), DELAY );
+
+			std::vector<int> xs, ys, zs;
+			for( int_ i = 0; i < 50; i++ )
+			{
+				x.step( &xs );
+				y.step( &ys );
+
+				ASSERT_EQ( xs, ys );
+			}
+
+			x.save( path );
+			cpu::snn<TypeParam> z( path, 2 );
+			ASSERT_EQ( z.delay(), DELAY );
+
+			for( int_ i = 0; i < 50; i++ )
+			{
+				x.step( &xs );
+				y.step( &ys );
+				z.step( &zs );
+
+				ASSERT_EQ( xs, ys );
+				ASSERT_EQ( xs, zs );
+			}
+			ASSERT_EQ( x.neurons(), y.neurons() );
+			ASSERT_EQ( x.neurons(), z.neurons() );
+
+			std::remove( path.c_str() );
+
+			// Transposition requires uniform delays
+			ASSERT_THROW(
+			    ( cpu::snn<TypeParam>( desc, DT, DELAY, 1, 1337, true ) ), std::invalid_argument );
+		}
+	}
+	else
+		// Plasticity requires uniform delays
+		ASSERT_THROW(
+		    ( cpu::snn<TypeParam>(
+		        layout( { N / 2, N / 2 }, { { 0, 1, P, DELAY }, { 1, 0, P, DELAY + 1 } } ),
+		        DT,
+		        DELAY ) ),
+		    std::invalid_argument );
+}
+
+TEST( SNN, Inputs )
+{
+	// Receiving into input accumulators only changes the order in which weights are summed
+	cpu::snn<brunel> x( { N, P }, DT, DELAY, 1, 1337 );
+	cpu::snn<brunel_with_inputs> y( { N, P }, DT, DELAY, 1, 1337 );
+	cpu::snn<brunel_with_inputs> z( { N, P }, DT, DELAY, 3, 1337, true );
+
+	ASSERT_EQ( x.adj(), y.adj() );
+
+	size_ nx = 0, ny = 0;
+	std::vector<int> xs, ys, zs;
+	for( int_ i = 0; i < 100; i++ )
+	{
+		x.step( &xs );
+		y.step( &ys );
+		z.step( &zs );
+
+		nx += xs.size();
+		ny += ys.size();
+		ASSERT_EQ( ys, zs );
+	}
+
+	ASSERT_GT( nx, 0u );
+	ASSERT_NEAR( nx, ny, nx / 100 );
+
+	auto const xn = x.neurons();
+	auto const yn = y.neurons();
+	// (the first half are Poisson neurons, brunel accumulates into their unused potentials)
+	for( size_ i = N / 2; i < N; i++ )
+		ASSERT_NEAR( std::get<0>( xn[i] ), std::get<0>( yn[i] ), 1e-5f );
+	ASSERT_EQ( y.neurons(), z.neurons() );
+}
+
+TYPED_TEST( SNN, Prebuilt )
+{
+	// Networks simulating a prebuilt (copy of a generated) graph match the original
+	std::string const path = ::testing::TempDir() + "spice_adj.bin";
+
+	cpu::snn<TypeParam> x( { N, P }, DT, DELAY, 1, 1337 );
+
+	std::vector<int> edges;
+	std::vector<size_> offsets;
+	util::adj_list::generate( { N, P }, edges, offsets, 1337 );
+	util::adj_file::write( path, { N, offsets.data(), edges.data() } );
+
+	auto const [adj, width] = x.adj();
+	cpu::snn<TypeParam> y( util::adj_list( N, width, adj.data() ), DT, DELAY, 1, 1337 );
+	cpu::snn<TypeParam> z( util::adj_file( path ), DT, DELAY, 3, 1337, true );
+
+	ASSERT_EQ( x.adj(), y.adj() );
+	ASSERT_EQ( x.adj(), z.adj() );
+	ASSERT_EQ( x.neurons(), y.neurons() );
+	ASSERT_EQ( x.neurons(), z.neurons() );
+
+	std::vector<int> xs, ys, zs;
+	for( int_ i = 0; i < 100; i++ )
+	{
+		x.step( &xs );
+		y.step( &ys );
+		z.step( &zs );
+
+		ASSERT_EQ( xs, ys );
+		ASSERT_EQ( xs, zs );
+	}
+
+	ASSERT_EQ( x.neurons(), y.neurons() );
+	ASSERT_EQ( x.synapses(), y.synapses() );
+	ASSERT_EQ( x.neurons(), z.neurons() );
+	ASSERT_EQ( x.synapses(), z.synapses() );
+
+	std::remove( path.c_str() );
+
+	// Neighbors must be sorted
+	std::vector<int> const unsorted{ 1, 0, -1, -1 };
+	ASSERT_THROW(
+	    ( cpu::snn<TypeParam>( util::adj_list( 2, 2, unsorted.data() ), DT ) ),
+	    std::invalid_argument );
+}
+
+TYPED_TEST( SNN, Run )
+{
+	// run() is equivalent to calling step() repeatedly
+	cpu::snn<TypeParam> x( { N, P }, DT, DELAY, 1, 1337 );
+	cpu::snn<TypeParam> y( { N, P }, DT, DELAY, 1, 1337 );
+
+	std::vector<std::vector<int>> xs( 100 ), ys;
+	for( auto & spikes : xs ) x.step( &spikes );
+
+	y.run( 60, [&]( int_ const istep, nonstd::span<int const> spikes ) {
+		ASSERT_EQ( istep, util::narrow_cast<int_>( ys.size() ) );
+		ys.emplace_back( spikes.begin(), spikes.end() );
+	} );
+	y.run( 40, [&]( int_, nonstd::span<int const> spikes ) {
+		ys.emplace_back( spikes.begin(), spikes.end() );
+	} );
+
+	ASSERT_EQ( xs, ys );
+	ASSERT_EQ( x.neurons(), y.neurons() );
+	ASSERT_EQ( x.synapses(), y.synapses() );
+
+	y.run( 10 );
+}
+
+TYPED_TEST( SNN, Checkpoint )
+{
+	std::string const path = ::testing::TempDir() + "spice_checkpoint.bin";
+
+	cpu::snn<TypeParam> x( { N, P }, DT, DELAY, 1, 1337 );
+	x.run( 50 );
+	x.save( path );
+
+	// Restoring resumes exactly where we left off, regardless of threads or transposition
+	cpu::snn<TypeParam> y( path );
+	cpu::snn<TypeParam> z( path, 3, true );
+
+	ASSERT_EQ( y.num_neurons(), N );
+	ASSERT_EQ( y.dt(), DT );
+	ASSERT_EQ( y.delay(), DELAY );
+	ASSERT_EQ( x.adj(), y.adj() );
+	ASSERT_EQ( x.neurons(), y.neurons() );
+	ASSERT_EQ( x.synapses(), y.synapses() );
+
+	std::vector<int> xs, ys, zs;
+	for( int_ i = 0; i < 100; i++ )
+	{
+		x.step( &xs );
+		y.step( &ys );
+		z.step( &zs );
+
+		ASSERT_EQ( xs, ys );
+		ASSERT_EQ( xs, zs );
+	}
+
+	ASSERT_EQ( x.neurons(), y.neurons() );
+	ASSERT_EQ( x.synapses(), y.synapses() );
+	ASSERT_EQ( x.neurons(), z.neurons() );
+
+	// Restored networks can be saved in turn. The checkpoint they were restored from is
+	// unaffected by their progress.
+	y.save( path + "2" );
+	cpu::snn<TypeParam> v( path + "2" );
+	ASSERT_EQ( x.neurons(), v.neurons() );
+	ASSERT_EQ( x.synapses(), v.synapses() );
+
+	cpu::snn<TypeParam> w( path );
+	w.run( 100 );
+	ASSERT_EQ( x.neurons(), w.neurons() );
+
+	std::remove( path.c_str() );
+	std::remove( ( path + "2" ).c_str() );
+
+	ASSERT_THROW( ( cpu::snn<TypeParam>( path ) ), std::runtime_error );
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <spice/util/adj_file.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+
+
+using namespace spice::util;
+
+
+static std::string const PATH = ::testing::TempDir() + "spice_adj.bin";
+
+TEST( AdjFile, Roundtrip )
+{
+	layout const desc( { 100, 400 }, { { 0, 1, 0.1f }, { 1, 0, 0.2f }, { 1, 1, 0.05f } } );
+
+	// CSR
+	{
+		std::vector<int> e;
+		std::vector<size_> o;
+		adj_list::generate( desc, e, o, 1337 );
+		adj_file::write( PATH, { desc.size(), o.data(), e.data() } );
+
+		adj_file f( PATH );
+		ASSERT_NE( f.adj().offsets(), nullptr );
+		ASSERT_EQ( f.adj().num_nodes(), desc.size() );
+		ASSERT_EQ( f.adj().num_edges(), e.size() );
+		ASSERT_EQ( std::vector<size_>( f.adj().offsets(), f.adj().offsets() + o.size() ), o );
+		ASSERT_EQ( std::vector<int>( f.adj().edges(), f.adj().edges() + e.size() ), e );
+		// Arrays are page-aligned
+		ASSERT_EQ( reinterpret_cast<std::uintptr_t>( f.adj().edges() ) % 4096, 0u );
+
+		// Copies share the mapping
+		adj_file const g = f;
+		ASSERT_EQ( g.adj().edges(), f.adj().edges() );
+	}
+
+	// ELL
+	{
+		std::vector<int> e;
+		adj_list::generate( desc, e, 1337 );
+		adj_file::write( PATH, { desc.size(), desc.max_degree(), e.data() } );
+
+		adj_file f( PATH );
+		ASSERT_EQ( f.adj().offsets(), nullptr );
+		ASSERT_EQ( f.adj().max_degree(), desc.max_degree() );
+		ASSERT_EQ( std::vector<int>( f.adj().edges(), f.adj().edges() + e.size() ), e );
+	}
+
+	// Empty
+	{
+		std::vector<size_> o( 11, 0 );
+		adj_file::write( PATH, { 10, o.data(), nullptr } );
+
+		adj_file f( PATH );
+		ASSERT_EQ( f.adj().num_nodes(), 10u );
+		ASSERT_EQ( f.adj().num_edges(), 0u );
+	}
+
+	std::remove( PATH.c_str() );
+}
+
+TEST( AdjFile, Invalid )
+{
+	// Unsorted
+	{
+		std::vector<int> e{ 1, 0 };
+		std::vector<size_> o{ 0, 2, 2 };
+		ASSERT_THROW( adj_file::write( PATH, { 2, o.data(), e.data() } ), std::invalid_argument );
+	}
+
+	// Out of bounds
+	{
+		std::vector<int> e{ 0, 2 };
+		ASSERT_THROW( adj_file::write( PATH, { 2, 1, e.data() } ), std::invalid_argument );
+	}
+
+	// Not an adjacency file
+	{
+		std::FILE * f = std::fopen( PATH.c_str(), "wb" );
+		std::fputs( "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef", f );
+		std::fclose( f );
+
+		ASSERT_THROW( ( adj_file( PATH ) ), std::invalid_argument );
+	}
+
+	std::remove( PATH.c_str() );
+	ASSERT_THROW( ( adj_file( PATH ) ), std::runtime_error );
+}
+
+TEST( AdjFile, Corrupt )
+{
+	// Overwrites the 'i'-th element of type T in the array starting at byte 'offset'
+	auto const patch = []( long const offset, int_ const i, auto const x ) {
+		std::FILE * f = std::fopen( PATH.c_str(), "r+b" );
+		ASSERT_NE( f, nullptr );
+		ASSERT_EQ( std::fseek( f, offset + i * long( sizeof( x ) ), SEEK_SET ), 0 );
+		ASSERT_EQ( std::fwrite( &x, sizeof( x ), 1, f ), 1u );
+		ASSERT_EQ( std::fclose( f ), 0 );
+	};
+
+	std::vector<int> const e{ 1, 2, 0, 2 };
+	std::vector<size_> const o{ 0, 2, 2, 4 };
+	// Arrays start at page boundaries (after the header, and after the offsets)
+	long const offsets = 4096, edges = 8192;
+
+	// Out of bounds id (CSR)
+	adj_file::write( PATH, { 3, o.data(), e.data() } );
+	ASSERT_NO_THROW( ( adj_file( PATH ) ) );
+	patch( edges, 3, int_( 3 ) );
+	ASSERT_THROW( ( adj_file( PATH, 2 ) ), std::invalid_argument );
+	patch( edges, 3, int_( -7 ) );
+	ASSERT_THROW( ( adj_file( PATH ) ), std::invalid_argument );
+
+	// Unsorted
+	adj_file::write( PATH, { 3, o.data(), e.data() } );
+	patch( edges, 0, int_( 2 ) );
+	patch( edges, 1, int_( 1 ) );
+	ASSERT_THROW( ( adj_file( PATH ) ), std::invalid_argument );
+
+	// Decreasing offsets
+	adj_file::write( PATH, { 3, o.data(), e.data() } );
+	patch( offsets, 1, size_( 3 ) );
+	ASSERT_THROW( ( adj_file( PATH ) ), std::invalid_argument );
+
+	// Out of bounds id (ELL)
+	adj_file::write( PATH, { 3, 1, e.data() } );
+	ASSERT_NO_THROW( ( adj_file( PATH ) ) );
+	patch( offsets, 2, int_( 1000000 ) ); // (no offsets: edges follow the header)
+	ASSERT_THROW( ( adj_file( PATH, 3 ) ), std::invalid_argument );
+
+	std::remove( PATH.c_str() );
+}
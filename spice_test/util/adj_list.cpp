@@ -2,6 +2,8 @@
 
 #include <spice/util/adj_list.h>
 
+#include <algorithm>
+
 
 using namespace spice::util;
 
@@ -147,4 +149,172 @@ TEST( AdjList, Ctor )
 			ASSERT_EQ( adj.neighbors( i ).size(), 0u );
 		}
 	}
-}
\ No newline at end of file
+}
+
+TEST( AdjList, CSR )
+{
+	{
+		std::vector<int> e{ 1, 2, 0, 2 };
+		std::vector<size_> o{ 0, 2, 2, 4 };
+
+		adj_list x( 3, o.data(), e.data() );
+
+		ASSERT_EQ( x.num_nodes(), 3u );
+		ASSERT_EQ( x.max_degree(), 2u );
+		ASSERT_EQ( x.num_edges(), 4u );
+		ASSERT_EQ( x.offsets(), o.data() );
+
+		ASSERT_EQ( x.neighbors( 0 ).size(), 2u );
+		ASSERT_EQ( x.neighbors( 1 ).size(), 0u );
+		ASSERT_EQ( x.neighbors( 2 ).size(), 2u );
+
+		ASSERT_EQ( x.neighbors( 2 )[0], 0 );
+		ASSERT_EQ( x.edge_index( 2, 1 ), 3u );
+	}
+
+	{
+		std::vector<int> e;
+		std::vector<size_> o;
+		layout desc( 100, 1 );
+		adj_list::generate( desc, e, o );
+
+		adj_list x( 100, o.data(), e.data() );
+
+		ASSERT_EQ( o.size(), 101u );
+		ASSERT_EQ( x.max_degree(), 100u );
+		ASSERT_EQ( x.num_edges(), 100u * 100u );
+		ASSERT_EQ( e.size(), x.num_edges() );
+
+		for( int_ i = 0; i < 100; i++ )
+		{
+			ASSERT_EQ( x.neighbors( i ).size(), 100u );
+
+			int_ j = 0;
+			for( auto n : x.neighbors( i ) )
+			{
+				ASSERT_EQ( n, j );
+				ASSERT_EQ( x.edge_index( i, j ), 100u * i + j );
+				++j;
+			}
+		}
+	}
+
+	{
+		std::vector<int> e;
+		std::vector<size_> o;
+		layout desc( 1000, 0.1f );
+		adj_list::generate( desc, e, o );
+
+		adj_list x( 1000, o.data(), e.data() );
+
+		// no padding
+		ASSERT_EQ( e.size(), x.num_edges() );
+
+		for( int_ i = 0; i < 1000; i++ )
+		{
+			int_ prev = -1;
+			for( auto y : x.neighbors( i ) )
+			{
+				ASSERT_GE( y, 0 );
+				ASSERT_LT( y, 1000 );
+
+				ASSERT_GT( y, prev );
+				prev = y;
+			}
+		}
+	}
+}
+
+TEST( AdjList, GenerateDeterministic )
+{
+	layout desc( { 500, 300 }, { { 0, 0, 0.1f }, { 0, 1, 0.2f }, { 1, 0, 0.5f } } );
+
+	{
+		std::vector<int> e1, e4, e7, f;
+		adj_list::generate( desc, e1, 42, 1 );
+		adj_list::generate( desc, e4, 42, 4 );
+		adj_list::generate( desc, e7, 42, 7 );
+		adj_list::generate( desc, f, 43, 4 );
+
+		ASSERT_EQ( e1, e4 );
+		ASSERT_EQ( e1, e7 );
+		ASSERT_NE( e1, f );
+	}
+
+	{
+		std::vector<int> e1, e4, e7, f;
+		std::vector<size_> o1, o4, o7, g;
+		adj_list::generate( desc, e1, o1, 42, 1 );
+		adj_list::generate( desc, e4, o4, 42, 4 );
+		adj_list::generate( desc, e7, o7, 42, 7 );
+		adj_list::generate( desc, f, g, 43, 4 );
+
+		ASSERT_EQ( e1, e4 );
+		ASSERT_EQ( o1, o4 );
+		ASSERT_EQ( e1, e7 );
+		ASSERT_EQ( o1, o7 );
+		ASSERT_NE( e1, f );
+
+		// ELL and CSR agree as long as no node exceeds desc.max_degree()
+		std::vector<int> ell;
+		adj_list::generate( desc, ell, 42 );
+		adj_list x( desc.size(), desc.max_degree(), ell.data() );
+		adj_list y( desc.size(), o1.data(), e1.data() );
+		for( size_ i = 0; i < desc.size(); i++ )
+		{
+			auto const a = x.neighbors( i );
+			auto const b = y.neighbors( i );
+			if( b.size() > desc.max_degree() ) continue;
+
+			ASSERT_TRUE( std::equal( a.begin(), a.end(), b.begin(), b.end() ) );
+		}
+	}
+
+	{
+		// more threads than nodes
+		std::vector<int> e1, e4;
+		std::vector<size_> o1, o4;
+		adj_list::generate( layout( 3, 0.5f ), e1, o1, 7, 1 );
+		adj_list::generate( layout( 3, 0.5f ), e4, o4, 7, 4 );
+
+		ASSERT_EQ( e1, e4 );
+		ASSERT_EQ( o1, o4 );
+	}
+}
+
+TEST( AdjList, GenerateIndependentSeeds )
+{
+	// Consecutive seeds yield independent graphs, not shifted copies of each other
+	layout const desc( 1000, 0.1f );
+	std::vector<int> e, f;
+	std::vector<size_> o, g;
+	adj_list::generate( desc, e, o, 42, 4 );
+	adj_list::generate( desc, f, g, 43, 4 );
+
+	size_ shifted = 0;
+	for( size_ i = 0; i + 1 < desc.size(); i++ )
+		shifted += std::equal(
+		    e.begin() + o[i + 1], e.begin() + o[i + 2], f.begin() + g[i], f.begin() + g[i + 1] );
+	ASSERT_EQ( shifted, 0u );
+}
+
+TEST( AdjList, Regenerate )
+{
+	layout const desc( { 100, 400 }, { { 0, 1, 0.1f }, { 1, 0, 0.2f }, { 1, 1, 0.05f } } );
+
+	std::vector<int> e;
+	std::vector<size_> o, o2;
+	adj_list::generate( desc, e, o, 1337, 3 );
+	adj_list::generate_offsets( desc, o2, 1337, 2 );
+
+	ASSERT_EQ( o, o2 );
+
+	std::vector<int> row;
+	for( size_ i = 0; i < desc.size(); i++ )
+	{
+		adj_list::regenerate( desc, 1337, i, row );
+		ASSERT_EQ( row, std::vector<int>( e.begin() + o[i], e.begin() + o[i + 1] ) );
+	}
+
+	ASSERT_THROW( adj_list::regenerate( desc, 0, 0, row ), std::invalid_argument );
+}
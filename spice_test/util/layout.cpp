@@ -2,6 +2,8 @@
 
 #include <spice/util/layout.h>
 
+#include <stdexcept>
+
 
 using namespace spice::util;
 
@@ -46,6 +48,42 @@ TEST( Layout, FromPopConnect )
 	ASSERT_EQ( l.connections()[2], std::make_tuple( 30, 60, 10, 30, 0.25f ) );
 }
 
+TEST( Layout, Delays )
+{
+	{
+		layout l( { 10, 20 }, { { 1, 0, 0.5f } } );
+		ASSERT_EQ( l.delays(), std::vector<int_>{ 0 } );
+		ASSERT_EQ( l.min_delay( 3 ), 3 );
+		ASSERT_EQ( l.max_delay( 3 ), 3 );
+	}
+	{
+		layout l( { 10, 20 }, { { 1, 1, 0.5f, 0 }, { 1, 0, 0.25f, 7 }, { 0, 1, 0.125f, 2 } } );
+
+		// sorted along with connections()
+		ASSERT_EQ( l.connections()[0], std::make_tuple( 0, 10, 10, 30, 0.125f ) );
+		ASSERT_EQ( l.delays(), ( std::vector<int_>{ 2, 7, 0 } ) );
+		ASSERT_EQ( l.min_delay( 3 ), 2 );
+		ASSERT_EQ( l.max_delay( 3 ), 7 );
+		ASSERT_EQ( l.min_delay( 1 ), 1 );
+		ASSERT_EQ( l.max_delay( 10 ), 10 );
+
+		// cuts retain delays
+		auto const s = l.cut( { 0, 10 } );
+		ASSERT_EQ( s.part.connections().size(), 1u );
+		ASSERT_EQ( s.part.delays(), std::vector<int_>{ 7 } );
+
+		auto const t = l.cut( 10, 3, 1 );
+		ASSERT_EQ( t.connections().size(), 2u );
+		ASSERT_EQ( t.delays(), ( std::vector<int_>{ 2, 0 } ) );
+	}
+	{
+		layout l( { 10 }, std::vector<std::tuple<size_, size_, float, int_>>{} );
+		ASSERT_EQ( l.min_delay( 4 ), 4 );
+	}
+
+	ASSERT_THROW( layout( { 10 }, { { 0, 0, 0.5f, -1 } } ), std::invalid_argument );
+}
+
 TEST( Layout, Slice )
 {
 	{
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <spice/util/packed_adj_list.h>
+#include <spice/util/type_traits.h>
+
+#include <algorithm>
+#include <limits>
+
+
+using namespace spice::util;
+
+
+// @return the neighbors of node i in [first, last) along with their edge indices
+template <typename Adj>
+static std::vector<std::pair<size_, int>>
+neighbors( Adj const & adj, size_ i, int_ first, int_ last );
+
+template <>
+std::vector<std::pair<size_, int>>
+neighbors( adj_list const & adj, size_ const i, int_ const first, int_ const last )
+{
+	std::vector<std::pair<size_, int>> result;
+	auto const row = adj.neighbors( i );
+	for( size_ j = 0; j < row.size(); j++ )
+		if( row[j] >= first && row[j] < last )
+			result.push_back( { adj.edge_index( i, j ), row[j] } );
+	return result;
+}
+
+template <>
+std::vector<std::pair<size_, int>>
+neighbors( packed_adj_list const & adj, size_ const i, int_ const first, int_ const last )
+{
+	std::vector<std::pair<size_, int>> result;
+	adj.for_each_neighbor(
+	    i,
+	    [&]( size_ j, int_ dst ) { result.push_back( { adj.edge_index( i, j ), dst } ); },
+	    first,
+	    last );
+	return result;
+}
+
+static void check( adj_list const & adj )
+{
+	packed_adj_list const packed( adj );
+
+	ASSERT_EQ( packed.num_nodes(), adj.num_nodes() );
+
+	int_ const N = narrow<int>( adj.num_nodes() );
+	for( size_ i = 0; i < adj.num_nodes(); i++ )
+	{
+		ASSERT_EQ(
+		    neighbors( packed, i, 0, std::numeric_limits<int_>::max() ),
+		    neighbors( adj, i, 0, std::numeric_limits<int_>::max() ) );
+
+		for( auto [first, last] : { std::pair{ 0, N / 3 }, { N / 3, N / 2 }, { N - 7, N } } )
+			ASSERT_EQ( neighbors( packed, i, first, last ), neighbors( adj, i, first, last ) );
+	}
+}
+
+TEST( PackedAdjList, Ctor )
+{
+	{
+		packed_adj_list x;
+		ASSERT_EQ( x.num_nodes(), 0u );
+		ASSERT_EQ( x.num_edges(), 0u );
+	}
+
+	layout const desc( { 1000, 4000 }, { { 0, 1, 0.1f }, { 1, 0, 0.2f }, { 1, 1, 0.05f } } );
+
+	// CSR
+	{
+		std::vector<int> e;
+		std::vector<size_> o;
+		adj_list::generate( desc, e, o, 1337 );
+		adj_list const adj( desc.size(), o.data(), e.data() );
+
+		check( adj );
+
+		packed_adj_list const packed( adj );
+		ASSERT_EQ( packed.num_edges(), e.size() );
+		// Ids need 13 bits, gaps far fewer
+		ASSERT_LT( packed.size_in_bytes(), e.size() * sizeof( int ) / 2 );
+	}
+
+	// ELL, edge indices include padding
+	{
+		std::vector<int> e;
+		adj_list::generate( desc, e, 1337 );
+
+		check( { desc.size(), desc.max_degree(), e.data() } );
+	}
+
+	// Duplicates, large gaps, blocks of 1
+	{
+		std::vector<int> const e{ 0,  0,  0, 5, 5, 2'000'000'000, 3, 4, 5, 6, 7, 8, 9, 10,
+		                          11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25,
+		                          26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 1'000'000 };
+		std::vector<size_> const o{ 0, 6, 6, 40, 41 };
+
+		check( { 4, o.data(), e.data() } );
+	}
+}
+
+TEST( PackedAdjList, Unsorted )
+{
+	std::vector<int> const e{ 1, 0 };
+	std::vector<size_> const o{ 0, 2, 2 };
+
+	ASSERT_THROW( packed_adj_list( { 2, o.data(), e.data() } ), std::invalid_argument );
+}
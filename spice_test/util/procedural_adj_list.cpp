@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include <spice/util/procedural_adj_list.h>
+
+#include <algorithm>
+
+
+using namespace spice::util;
+
+
+TEST( ProceduralAdjList, Ctor )
+{
+	layout const desc( { 100, 400 }, { { 0, 1, 0.1f }, { 1, 0, 0.2f }, { 1, 1, 0.05f } } );
+
+	std::vector<int> e;
+	std::vector<size_> o;
+	adj_list::generate( desc, e, o, 1337 );
+	adj_list const adj( desc.size(), o.data(), e.data() );
+
+	procedural_adj_list const x( desc, 1337, 4 );
+
+	ASSERT_EQ( x.num_nodes(), adj.num_nodes() );
+	ASSERT_EQ( x.num_edges(), adj.num_edges() );
+	ASSERT_EQ( x.max_degree(), adj.max_degree() );
+
+	for( size_ i = 0; i < desc.size(); i++ )
+	{
+		auto const row = adj.neighbors( i );
+
+		// Whole row
+		std::vector<int> all;
+		x.for_each_neighbor( i, [&]( size_ j, int_ dst ) {
+			ASSERT_EQ( x.edge_index( i, j ), adj.edge_index( i, j ) );
+			all.push_back( dst );
+		} );
+		ASSERT_EQ( all, std::vector<int>( row.begin(), row.end() ) );
+
+		// Range
+		std::vector<int> part;
+		x.for_each_neighbor( i, [&]( size_, int_ dst ) { part.push_back( dst ); }, 50, 150 );
+		std::vector<int> expected;
+		std::copy_if( row.begin(), row.end(), std::back_inserter( expected ), []( int_ dst ) {
+			return dst >= 50 && dst < 150;
+		} );
+		ASSERT_EQ( part, expected );
+	}
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <spice/util/propagator.h>
+
+#include <cmath>
+#include <tuple>
+
+
+using namespace spice;
+using namespace spice::util;
+
+
+// Minimal neuron iterator over a tuple of attributes
+template <typename... T>
+struct state
+{
+	std::tuple<T...> * data;
+
+	template <int_ I>
+	auto & get()
+	{
+		return std::get<I>( *data );
+	}
+};
+
+
+TEST( Propagator, Identity )
+{
+	std::tuple<float, int> x{ 1.5f, 7 };
+	propagator<0, 1>().apply( state<float, int>{ &x } );
+
+	ASSERT_EQ( x, std::make_tuple( 1.5f, 7 ) );
+}
+
+TEST( Propagator, Decay )
+{
+	// dV/dt = ( Vrest - V ) / T
+	double const T = 0.02, Vrest = -0.06;
+	linear_dynamics<0> sys;
+	sys.A[0][0] = -1.0 / T;
+	sys.b[0] = Vrest / T;
+
+	for( float dt : { 0.0001f, 0.001f, 0.01f, 0.1f } )
+	{
+		std::tuple<float> x{ 0.0f };
+		propagator<0>( sys, dt ).apply( state<float>{ &x } );
+
+		ASSERT_NEAR( std::get<0>( x ), Vrest * ( 1.0 - std::exp( -dt / T ) ), 1e-7 );
+	}
+}
+
+TEST( Propagator, Coupled )
+{
+	// Current-based synapse driving a membrane: dI/dt = -I / Ts, dV/dt = ( I - V ) / Tm
+	double const Ts = 0.005, Tm = 0.02;
+	linear_dynamics<0, 1> sys;
+	sys.A[0][0] = -1.0 / Ts;
+	sys.A[1][0] = 1.0 / Tm;
+	sys.A[1][1] = -1.0 / Tm;
+
+	float const dt = 0.004f;
+	std::tuple<float, float> x{ 1.0f, 0.0f };
+	propagator<0, 1>( sys, dt ).apply( state<float, float>{ &x } );
+
+	// I(t) = exp( -t / Ts ), V(t) = Ts / ( Ts - Tm ) * ( exp( -t / Ts ) - exp( -t / Tm ) )
+	ASSERT_NEAR( std::get<0>( x ), std::exp( -dt / Ts ), 1e-6 );
+	double const V = Ts / ( Ts - Tm ) * ( std::exp( -dt / Ts ) - std::exp( -dt / Tm ) );
+	ASSERT_NEAR( std::get<1>( x ), V, 1e-6 );
+}
+
+TEST( Propagator, StepSize )
+{
+	// One large step equals many small ones (up to rounding), unlike forward Euler
+	linear_dynamics<0> sys;
+	sys.A[0][0] = -50.0;
+	sys.b[0] = 1.0;
+
+	std::tuple<float> x{ 0.0f }, y{ 0.0f };
+	propagator<0>( sys, 0.01f ).apply( state<float>{ &x } );
+
+	propagator<0> const small( sys, 0.0001f );
+	for( int_ i = 0; i < 100; i++ ) small.apply( state<float>{ &y } );
+
+	ASSERT_NEAR( std::get<0>( x ), std::get<0>( y ), 1e-6 );
+	ASSERT_NEAR( std::get<0>( x ), ( 1.0 - std::exp( -0.5 ) ) / 50.0, 1e-7 );
+}
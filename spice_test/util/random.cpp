@@ -139,4 +139,94 @@ TEST( Random, Binom )
 		}
 		EXPECT_NEAR( m / 10000.0, 90, 0.1 ) << "Test depends on rng, repeat it.";
 	}
-}
\ No newline at end of file
+}
+
+TEST( Random, Jump )
+{
+	// Reference values obtained by raising the generators' transition matrices to the power of
+	// 2^64/2^96 resp. 2^128/2^192 over GF(2)
+	{
+		xoroshiro128p rng( 1 );
+		rng.jump();
+		ASSERT_EQ( rng(), 0xb9a590abu );
+		ASSERT_EQ( rng(), 0x3b9169cbu );
+	}
+	{
+		xoroshiro128p rng( 1 );
+		rng.long_jump();
+		ASSERT_EQ( rng(), 0xbbccd863u );
+		ASSERT_EQ( rng(), 0xcc4d0650u );
+	}
+	{
+		xoroshiro256ss rng( 1 );
+		rng.jump();
+		ASSERT_EQ( rng(), 0x3ccc28c4262e1d51llu );
+		ASSERT_EQ( rng(), 0xb712a76cb7938a24llu );
+	}
+	{
+		xoroshiro256ss rng( 1 );
+		rng.long_jump();
+		ASSERT_EQ( rng(), 0xac5705e9a578f654llu );
+		ASSERT_EQ( rng(), 0xca83839ec3fda68dllu );
+	}
+}
+
+TEST( Random, Philox )
+{
+	// Known-answer tests from Random123 (kat_vectors)
+	{
+		uint_ const ctr[4] = {};
+		uint_ const key[2] = {};
+		uint_ out[4];
+		philox4x32_10::block( ctr, key, out );
+		ASSERT_EQ( out[0], 0x6627e8d5u );
+		ASSERT_EQ( out[1], 0xe169c58du );
+		ASSERT_EQ( out[2], 0xbc57ac4cu );
+		ASSERT_EQ( out[3], 0x9b00dbd8u );
+	}
+	{
+		uint_ const ctr[4] = { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff };
+		uint_ const key[2] = { 0xffffffff, 0xffffffff };
+		uint_ out[4];
+		philox4x32_10::block( ctr, key, out );
+		ASSERT_EQ( out[0], 0x408f276du );
+		ASSERT_EQ( out[1], 0x41c83b0eu );
+		ASSERT_EQ( out[2], 0xa20bc7c6u );
+		ASSERT_EQ( out[3], 0x6d5451fdu );
+	}
+	{
+		uint_ const ctr[4] = { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 };
+		uint_ const key[2] = { 0xa4093822, 0x299f31d0 };
+		uint_ out[4];
+		philox4x32_10::block( ctr, key, out );
+		ASSERT_EQ( out[0], 0xd16cfe09u );
+		ASSERT_EQ( out[1], 0x94fdccebu );
+		ASSERT_EQ( out[2], 0x5001e420u );
+		ASSERT_EQ( out[3], 0x24126ea1u );
+	}
+
+	// Streams
+	{
+		philox4x32_10 rng( 0x299f31d0a4093822llu );
+		rng.seek( 0x85a308d3, 0x13198a2e, 0x03707344 );
+
+		uint_ const key[2] = { 0xa4093822, 0x299f31d0 };
+		for( uint_ b = 0; b < 3; b++ )
+		{
+			uint_ const ctr[4] = { b, 0x85a308d3, 0x13198a2e, 0x03707344 };
+			uint_ out[4];
+			philox4x32_10::block( ctr, key, out );
+
+			for( int_ i = 0; i < 4; i++ ) ASSERT_EQ( rng(), out[i] );
+		}
+
+		philox4x32_10 other( 0x299f31d0a4093822llu );
+		other.seek( 0x85a308d3, 0x13198a2e, 0x03707344 );
+		rng.seek( 0x85a308d3, 0x13198a2e, 0x03707344 );
+		for( int_ i = 0; i < 10; i++ ) ASSERT_EQ( rng(), other() );
+
+		other.seek( 1 );
+		rng.seek( 2 );
+		ASSERT_NE( rng(), other() );
+	}
+}
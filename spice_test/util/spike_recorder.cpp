@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <spice/cpu/snn.h>
+#include <spice/models/brunel.h>
+#include <spice/util/spike_recorder.h>
+
+#include <cstdio>
+#include <stdexcept>
+
+
+using namespace spice;
+using namespace spice::util;
+
+
+static std::string const PATH = ::testing::TempDir() + "spice_spikes.bin";
+
+TEST( SpikeRecorder, Roundtrip )
+{
+	std::vector<std::vector<int>> const steps = {
+	    {}, { 0 }, { 1, 5, 127, 128, 16384 }, {}, {}, { 2'000'000'000 }, { 3, 4 } };
+
+	{
+		spike_recorder rec( PATH );
+		for( size_ i = 0; i < steps.size(); i++ ) rec( narrow<int_>( i ), steps[i] );
+
+		ASSERT_THROW( rec( 3, steps[1] ), std::invalid_argument );
+		ASSERT_THROW( rec( 100, std::vector<int>{ 2, 1 } ), std::invalid_argument );
+	}
+
+	spike_reader r( PATH );
+	for( int_ pass = 0; pass < 2; pass++ )
+	{
+		int_ istep;
+		std::vector<int> spikes;
+		for( size_ i = 0; i < steps.size(); i++ )
+		{
+			if( steps[i].empty() ) continue;
+
+			ASSERT_TRUE( r.next( istep, spikes ) );
+			ASSERT_EQ( istep, narrow<int_>( i ) );
+			ASSERT_EQ( spikes, steps[i] );
+		}
+		ASSERT_FALSE( r.next( istep, spikes ) );
+
+		r.rewind();
+	}
+
+	std::remove( PATH.c_str() );
+}
+
+TEST( SpikeRecorder, Filter )
+{
+	{
+		spike_recorder rec( PATH, { { 2, 4 }, { 10, 11 } } );
+		rec( 0, std::vector<int>{ 0, 1, 2, 3, 4, 9, 10, 11 } );
+		rec( 1, std::vector<int>{ 5, 6 } );
+		rec( 2, std::vector<int>{ 10 } );
+	}
+
+	spike_reader r( PATH );
+	int_ istep;
+	std::vector<int> spikes;
+
+	ASSERT_TRUE( r.next( istep, spikes ) );
+	ASSERT_EQ( istep, 0 );
+	ASSERT_EQ( spikes, ( std::vector<int>{ 2, 3, 10 } ) );
+
+	ASSERT_TRUE( r.next( istep, spikes ) );
+	ASSERT_EQ( istep, 2 );
+	ASSERT_EQ( spikes, std::vector<int>{ 10 } );
+
+	ASSERT_FALSE( r.next( istep, spikes ) );
+
+	ASSERT_THROW( spike_recorder( PATH, { { 4, 8 }, { 2, 3 } } ), std::invalid_argument );
+
+	std::remove( PATH.c_str() );
+}
+
+TEST( SpikeRecorder, Close )
+{
+	// Many more chunks than may be pending at once
+	std::vector<int> spikes( 1000 );
+	for( size_ i = 0; i < spikes.size(); i++ ) spikes[i] = narrow<int>( i );
+
+	spike_recorder rec( PATH );
+	for( int_ i = 0; i < 20'000; i++ ) rec( i, spikes );
+	rec.close();
+	rec.close();
+	ASSERT_THROW( rec( 20'000, spikes ), std::invalid_argument );
+
+	spike_reader r( PATH );
+	int_ istep, nsteps = 0;
+	std::vector<int> read;
+	while( r.next( istep, read ) )
+	{
+		ASSERT_EQ( istep, nsteps++ );
+		ASSERT_EQ( read, spikes );
+	}
+	ASSERT_EQ( nsteps, 20'000 );
+
+	std::remove( PATH.c_str() );
+
+#ifdef __linux__
+	// Write errors surface in close()
+	spike_recorder full( "/dev/full" );
+	full( 0, spikes );
+	ASSERT_THROW( full.close(), std::runtime_error );
+#endif
+}
+
+TEST( SpikeRecorder, Sink )
+{
+	// Usable as a sink for run()
+	cpu::snn<brunel> x( { 1000, 0.1f }, 0.0001f, 15, 1, 1337 );
+	cpu::snn<brunel> y( { 1000, 0.1f }, 0.0001f, 15, 1, 1337 );
+	{
+		spike_recorder rec( PATH );
+		x.run( 5000, rec );
+	}
+
+	spike_reader r( PATH );
+	int_ istep;
+	std::vector<int> spikes, expected;
+	int_ nsteps = 0;
+	while( r.next( istep, spikes ) )
+	{
+		for( ; nsteps <= istep; nsteps++ ) y.step( &expected );
+		ASSERT_EQ( spikes, expected );
+	}
+	ASSERT_GT( nsteps, 4000 );
+
+	std::remove( PATH.c_str() );
+}